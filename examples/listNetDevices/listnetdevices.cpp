@@ -1,32 +1,37 @@
 #include <reroman/networkinterface.hpp>
+#include <iostream>
 using namespace std;
 using namespace reroman;
 
 int main()
 {
+	const char *states[] = { "unknown", "notpresent", "down", "lowerlayerdown",
+		"testing", "dormant", "up" };
+
 	try{
-		for( int i = 1 ; ; i++ ){
-			NetworkInterface nic( i );
-			cout << i << ") " << nic.getName()
-				<< "\n   Hw Address:\t" << nic.getHwAddress();
+		for( auto &nic : NetworkInterface::enumerate() ){
+			auto state = static_cast<unsigned int>( nic.getOperState() );
 
-			// Intenta obtener direcciones IP
-			try{
-				auto ip = nic.getAddress();
-				auto mask = nic.getNetmask();
+			cout << nic.getIndex() << ") " << nic.getName()
+				<< "\n   Hw Address:\t" << nic.getHwAddress()
+				<< "\n   MTU:\t\t" << nic.getMtu()
+				<< "\n   State:\t" << ( state < 7 ? states[state] : "unknown" );
 
-				cout << "\n   Network:\t" << IPv4Addr::makeNetAddress( ip, mask )
-					<< "\n   Netmask:\t" << mask
-					<< "\n   IP Address:\t" << ip
-					<< "\n   Broadcast:\t" << IPv4Addr::makeBroadcast( ip, mask )
-					<< '\n' <<endl;
-			}
-			catch( system_error& ){
-				cout << "\n\n";
+			for( auto &addr : nic.getAddresses() ){
+				cout << "\n\n   Network:\t"
+					<< IPv4Addr::makeNetAddress( addr.address, addr.netmask )
+					<< "\n   Netmask:\t" << addr.netmask
+					<< "\n   IP Address:\t" << addr.address
+					<< ( addr.secondary ? " (secondary)" : "" );
+				if( !addr.broadcast.isNull() )
+					cout << "\n   Broadcast:\t" << addr.broadcast;
 			}
+			cout << '\n' << endl;
 		}
 	}
-	catch( system_error & ){ // Ya no hay más dispositivos
-		return 0;
+	catch( system_error &e ){
+		cerr << e.what() << endl;
+		return 1;
 	}
+	return 0;
 }
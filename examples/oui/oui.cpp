@@ -0,0 +1,34 @@
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <reroman/ouidatabase.hpp>
+using namespace std;
+using namespace reroman;
+
+int main( int argc, char **argv )
+{
+	if( argc < 4 || ( strcmp( argv[1], "compile" ) && strcmp( argv[1], "lookup" ) ) ){
+		cerr << "Use: " << *argv << " compile <database> <registry.csv>..." << endl
+			<< "     " << *argv << " lookup <database> <hwaddr>..." << endl;
+		return -1;
+	}
+	try{
+		if( !strcmp( argv[1], "compile" ) ){
+			vector<string> registries( argv + 3, argv + argc );
+			cout << OuiDatabase::compile( registries, argv[2] )
+				<< " assignments compiled" << endl;
+			return 0;
+		}
+
+		OuiDatabase db( argv[2] );
+		for( int i = 3 ; i < argc ; i++ ){
+			const char *vendor = db.vendorOf( HwAddr( argv[i] ) );
+			cout << argv[i] << ' ' << ( vendor ? vendor : "(unknown)" ) << endl;
+		}
+		return 0;
+	}
+	catch( exception &e ){
+		cerr << e.what() << endl;
+		exit( EXIT_FAILURE );
+	}
+}
@@ -1,6 +1,9 @@
 #include <iostream>
 #include <csignal>
+#include <vector>
 #include <reroman/arp/arp.hpp>
+#include <reroman/targetlist.hpp>
+#include <reroman/ipv4network.hpp>
 using namespace std;
 using namespace reroman;
 using namespace reroman::arp;
@@ -8,26 +11,30 @@ using namespace reroman::arp;
 int main( int argc, char **argv )
 {
 	if( argc < 2 ){
-		cerr << "Use: " << *argv << " <interface>" << endl;
+		cerr << "Use: " << *argv << " <interface> [targets file]" << endl;
 		return -1;
 	}
 	try{
 		NetworkInterface nic( argv[1] );
 		ARPSocket sock( 150 );
-		int hostsUp = 0;
+		vector<IPv4Addr> targets;
 
-		auto ipLocal = nic.getAddress();
-		auto mask = nic.getNetmask();
-		auto request = IPv4Addr::makeNetAddress( ipLocal, mask ) + 1;
-		auto broad = IPv4Addr::makeBroadcast( ipLocal, mask );
+		if( argc > 2 ){
+			TargetList list( argv[2] );
+			for( size_t i = 0 ; i < list.getSize() ; i++ )
+				targets.push_back( IPv4Addr( list.getData()[i] ) );
+		}
+		else{
+			IPv4Network net( nic.getAddress(), nic.getNetmask() );
 
-		for(  ; request < broad ; request++ ){
-			cout << "Resolving " << request << '\r' << flush;
-			if( sock.resolve( request, nic ) ){
-				hostsUp++;
-				cout << request << " is up         " << endl;
-			}
+			for( const auto &ip : net.getHosts() )
+				targets.push_back( ip );
 		}
+
+		auto hostsUp = sock.resolveMany( targets, nic,
+				[]( const IPv4Addr &ip, const HwAddr &hw ){
+					cout << ip << " is up (" << hw << ')' << endl;
+				} );
 		cout << hostsUp << " hosts up              " << endl;
 		return 0;
 	}
@@ -35,4 +42,8 @@ int main( int argc, char **argv )
 		cerr << e.what() << endl;
 		exit( EXIT_FAILURE );
 	}
+	catch( invalid_argument &e ){
+		cerr << e.what() << endl;
+		exit( EXIT_FAILURE );
+	}
 }
@@ -38,6 +38,12 @@
 #define REROMAN_ARP_HPP
 
 #include <reroman/networkinterface.hpp>
+#include <functional>
+#include <vector>
+
+#include <cstring>
+
+struct sockaddr_ll;
 
 
 namespace reroman
@@ -49,6 +55,7 @@ namespace reroman
 	namespace arp
 	{
 		class ARPSocket;
+		class ARPBulkSender;
 
 		/**
 		 * @brief Agrega una entrada ethernet estática a la cache ARP del
@@ -126,6 +133,58 @@ namespace reroman
 			IPV4 = 0x0800 ///< Protocolo IPv4
 		};
 
+		/**
+		 * @brief Modos de distribución de tramas entre los sockets de un
+		 * grupo PACKET_FANOUT.
+		 */
+		enum class FanoutMode: uint16_t
+		{
+			HASH,		///< Por hash del flujo de la trama.
+			LB,			///< Por turnos (round-robin).
+			CPU,		///< Por el CPU que recibió la trama.
+			ROLLOVER,	///< Al siguiente socket cuando uno está lleno.
+			RANDOM,		///< Aleatoriamente.
+			QM			///< Por la cola de recepción del dispositivo.
+		};
+
+		/**
+		 * @brief Criterios para filtrar tramas ARP en el kernel.
+		 * @details Las tramas que no cumplen con todos los criterios se
+		 * descartan antes de copiarse al espacio de usuario.
+		 * @see ARPSocket::setFilter()
+		 * @headerfile arp.hpp <reroman/arp/arp.hpp>
+		 */
+		struct ARPFilter
+		{
+			/**
+			 * @brief Acepta sólo respuestas ARP.
+			 */
+			bool onlyReplies = true;
+
+			/**
+			 * @brief Acepta sólo tramas Ethernet/IPv4 con longitudes de
+			 * dirección de 6 y 4 bytes.
+			 */
+			bool onlyEthernetIPv4 = true;
+
+			/**
+			 * @brief Red a la cual debe pertenecer la IP de origen.
+			 * @details Se ignora si senderNetmask es 0.0.0.0.
+			 */
+			reroman::IPv4Addr senderNetwork;
+
+			/**
+			 * @brief Máscara de la red de origen.
+			 */
+			reroman::IPv4Addr senderNetmask;
+
+			/**
+			 * @brief IP destino que deben tener las tramas, generalmente la
+			 * dirección de la interfaz local. Se ignora si es 0.0.0.0.
+			 */
+			reroman::IPv4Addr targetAddr;
+		};
+
 		/**
 		 * @brief Define una trama ARP
 		 * @headerfile arp.hpp <reroman/arp/arp.hpp>
@@ -133,6 +192,7 @@ namespace reroman
 		class __attribute__((packed)) ARPFrame final
 		{
 			friend class ARPSocket;
+			friend class ARPBulkSender;
 		public:
 			//===============================================================
 			//							Constructores
@@ -256,6 +316,176 @@ namespace reroman
 			uint32_t ipTgt;
 		};
 
+		/**
+		 * @brief Vista sin copia de una trama ARP para IPv4 en memoria
+		 * ajena, por ejemplo dentro del anillo de recepción.
+		 * @details La trama se valida una sola vez al crear la vista: el
+		 * protocolo debe ser IPv4 con direcciones de 4 bytes, la longitud de
+		 * la dirección física debe coincidir con \p HwLen y el buffer debe
+		 * contener la trama completa. Después, los campos se leen
+		 * directamente del buffer, que debe seguir siendo válido mientras se
+		 * use la vista.
+		 *
+		 * Con \p HwLen distinto de 0 los desplazamientos de todos los campos
+		 * son constantes de compilación; con 0 se acepta cualquier longitud
+		 * y se leen de la cabecera de la trama. Los alias
+		 * EthernetARPFrameView e InfinibandARPFrameView cubren las
+		 * direcciones de 6 bytes y las de 20 bytes de IP sobre InfiniBand.
+		 * @tparam HwLen Longitud de la dirección física, o 0 para cualquiera.
+		 * @headerfile arp.hpp <reroman/arp/arp.hpp>
+		 */
+		template <uint8_t HwLen>
+		class BasicARPFrameView final
+		{
+		public:
+			//===============================================================
+			//							Constructores
+			//===============================================================
+			/**
+			 * @brief Crea una vista inválida.
+			 */
+			BasicARPFrameView( void ) noexcept = default;
+
+			/**
+			 * @brief Crea una vista sobre una trama.
+			 * @details Si la trama no es válida la vista queda inválida; no
+			 * se lanzan excepciones.
+			 * @param data Inicio de la cabecera ARP.
+			 * @param len Número de bytes disponibles a partir de \p data.
+			 */
+			BasicARPFrameView( const void *data, std::size_t len ) noexcept;
+
+
+			//===============================================================
+			//							Getters
+			//===============================================================
+			/**
+			 * @brief Verifica si la vista apunta a una trama válida.
+			 * @details El resto de los getters sólo pueden llamarse sobre una
+			 * vista válida.
+			 */
+			bool isValid( void ) const noexcept;
+
+			/**
+			 * @brief Equivale a isValid().
+			 */
+			explicit operator bool( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene el inicio de la trama.
+			 */
+			const uint8_t* getData( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene la longitud de la trama en bytes.
+			 */
+			std::size_t getSize( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene el tipo de hardware de la trama.
+			 */
+			HwType getHwType( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene el tipo de protocolo.
+			 */
+			Protocol getProtocol( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene la longitud de la dirección de hardware.
+			 */
+			uint8_t getHwLen( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene la longitud de la dirección de protocolo.
+			 */
+			uint8_t getProtocolLen( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene el código de operación.
+			 */
+			OperationCode getOpCode( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene los getHwLen() bytes de la dirección física de
+			 * origen.
+			 */
+			const uint8_t* getSourceHw( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene los getHwLen() bytes de la dirección física
+			 * destino.
+			 */
+			const uint8_t* getTargetHw( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene la dirección física de origen.
+			 * @details Sólo está disponible si \p HwLen es
+			 * HwAddr::HwAddrLen; con otras longitudes no compila.
+			 */
+			reroman::HwAddr getSourceHwAddr( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene la dirección física destino.
+			 * @details Sólo está disponible si \p HwLen es
+			 * HwAddr::HwAddrLen; con otras longitudes no compila.
+			 */
+			reroman::HwAddr getTargetHwAddr( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene la dirección IP de origen.
+			 */
+			reroman::IPv4Addr getSourceIPAddr( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene la dirección IP destino.
+			 */
+			reroman::IPv4Addr getTargetIPAddr( void ) const noexcept;
+
+
+			//===============================================================
+			//							Operaciones
+			//===============================================================
+			/**
+			 * @brief Obtiene una vista con la disposición de otra longitud de
+			 * dirección física.
+			 * @details Útil para pasar de una vista genérica a una con
+			 * desplazamientos constantes una vez conocido el tipo de hardware.
+			 * @tparam Len Longitud de la nueva vista.
+			 * @return La nueva vista, inválida si la longitud no coincide.
+			 */
+			template <uint8_t Len>
+			BasicARPFrameView<Len> as( void ) const noexcept;
+
+
+			//===============================================================
+			//						Miembros Estáticos
+			//===============================================================
+			static constexpr std::size_t HeaderLen = 8; ///< Bytes antes de la dirección física de origen.
+
+		private:
+			const uint8_t *data = nullptr;
+
+			uint8_t hwLen( void ) const noexcept;
+			uint32_t readIPv4( std::size_t offset ) const noexcept;
+		};
+
+		/**
+		 * @brief Vista de tramas con cualquier longitud de dirección física.
+		 */
+		using ARPFrameView = BasicARPFrameView<0>;
+
+		/**
+		 * @brief Vista de tramas Ethernet, con direcciones de 6 bytes.
+		 */
+		using EthernetARPFrameView = BasicARPFrameView<6>;
+
+		/**
+		 * @brief Vista de tramas de IP sobre InfiniBand (RFC 4391), con
+		 * direcciones de 20 bytes.
+		 */
+		using InfinibandARPFrameView = BasicARPFrameView<20>;
+
 		/**
 		 * @brief Representa un socket para enviar/recibir tramas ARP.
 		 * @headerfile arp.hpp <reroman/arp/arp.hpp>
@@ -263,6 +493,31 @@ namespace reroman
 		class ARPSocket final
 		{
 		public:
+			/**
+			 * @brief Función a invocar cada vez que se resuelve una dirección
+			 * durante ARPSocket::resolveMany().
+			 * @details Recibe la dirección IP resuelta y la dirección física
+			 * asociada a ella.
+			 */
+			using ResolveHandler = std::function<void( const reroman::IPv4Addr&,
+				  const reroman::HwAddr& )>;
+
+			/**
+			 * @brief Función a invocar por cada trama recibida durante
+			 * ARPSocket::receiveRing().
+			 * @details Recibe la trama y la dirección física del remitente. La
+			 * trama sólo es válida durante la llamada.
+			 */
+			using FrameHandler = std::function<void( const ARPFrame&,
+				  const reroman::HwAddr& )>;
+
+			/**
+			 * @brief Función a invocar por cada trama recibida durante
+			 * ARPSocket::receiveViews().
+			 * @details La vista sólo es válida durante la llamada.
+			 */
+			using FrameViewHandler = std::function<void( const ARPFrameView& )>;
+
 			//===============================================================
 			//							Constructores
 			//===============================================================
@@ -289,6 +544,54 @@ namespace reroman
 			 */
 			int getTimeout( void ) const noexcept;
 
+			/**
+			 * @brief Obtiene el número de tramas descartadas durante la última
+			 * llamada a resolve().
+			 * @details Se descartan las tramas ARP que no corresponden a la
+			 * respuesta esperada, como peticiones de otros hosts o ARP gratuitos.
+			 * @return El número de tramas descartadas.
+			 */
+			unsigned int getDiscardedFrames( void ) const noexcept;
+
+			/**
+			 * @brief Verifica si el socket recibe tramas mediante un anillo
+			 * en memoria compartida.
+			 * @return Verdadero si el anillo está activo, falso en caso contrario.
+			 * @see enableRxRing()
+			 */
+			bool isRxRingEnabled( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene el descriptor de archivo del socket.
+			 * @details Permite integrar el socket en ciclos de eventos externos
+			 * (poll, epoll, etc.). No debe cerrarse directamente.
+			 * @return El descriptor de archivo.
+			 */
+			int getNativeHandle( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene el descriptor que indica cuándo hay tramas
+			 * disponibles.
+			 * @details Es el socket, o la instancia de io_uring si está activa.
+			 * Es el descriptor que debe vigilarse con poll o epoll.
+			 * @return El descriptor de archivo.
+			 * @see enableUring()
+			 */
+			int getEventHandle( void ) const noexcept;
+
+			/**
+			 * @brief Verifica si el socket envía y recibe tramas mediante
+			 * io_uring.
+			 * @see enableUring()
+			 */
+			bool isUringEnabled( void ) const noexcept;
+
+			/**
+			 * @brief Verifica si el socket se encuentra en modo no bloqueante.
+			 * @see setNonBlocking()
+			 */
+			bool isNonBlocking( void ) const noexcept;
+
 			//===============================================================
 			//							Setters
 			//===============================================================
@@ -300,6 +603,65 @@ namespace reroman
 			 */
 			bool setTimeout( unsigned int msecs );
 
+			/**
+			 * @brief Activa/desactiva el modo no bloqueante.
+			 * @details En modo no bloqueante receive(), receiveBatch() y
+			 * receiveRing() regresan inmediatamente si no hay tramas
+			 * disponibles en lugar de esperar getTimeout() milisegundos.
+			 * resolve() y resolveMany() siguen esperando las respuestas.
+			 * @param value Un valor verdadero activa el modo no bloqueante.
+			 * @return Verdadero si la acción se completó con éxito, falso en caso
+			 * de error estableciendo el valor de errno.
+			 */
+			bool setNonBlocking( bool value );
+
+			/**
+			 * @brief Activa la recepción mediante un anillo PACKET_RX_RING
+			 * (TPACKET_V3) compartido con el kernel.
+			 * @details El kernel deposita las tramas en bloques de memoria
+			 * compartida y las entrega al usuario bloque por bloque, evitando
+			 * una llamada al sistema y una copia por trama. Una vez activo,
+			 * receive(), resolve() y resolveMany() leen del anillo.
+			 * @param blockSize Tamaño en bytes de cada bloque. Debe ser múltiplo
+			 * del tamaño de página.
+			 * @param blockCount Número de bloques del anillo.
+			 * @param retireMsecs Tiempo máximo en ms que el kernel retiene un
+			 * bloque que no se ha llenado antes de entregarlo.
+			 * @return Verdadero si el anillo se activó, falso en caso contrario
+			 * estableciendo el valor de errno.
+			 */
+			bool enableRxRing( unsigned int blockSize = 1 << 16,
+					unsigned int blockCount = 64, unsigned int retireMsecs = 10 );
+
+			/**
+			 * @brief Desactiva el anillo de recepción y regresa a la lectura
+			 * mediante recvfrom().
+			 */
+			void disableRxRing( void ) noexcept;
+
+			/**
+			 * @brief Activa el motor de entrada/salida basado en io_uring.
+			 * @details La recepción se hace con una sola petición recvmsg de
+			 * disparo múltiple sobre un anillo de buffers provistos, y los
+			 * envíos se encolan y se entregan al kernel en lote. Una vez
+			 * activo, todas las operaciones de envío y recepción lo utilizan;
+			 * send() y sendBatch() regresan al encolar las tramas, por lo que
+			 * los errores de envío no se reportan. Requiere Linux 6.0 o
+			 * superior; si no está disponible se sigue utilizando
+			 * sendto()/recvfrom(). No puede utilizarse junto con el anillo de
+			 * recepción.
+			 * @param entries Tamaño de la cola de envío de io_uring.
+			 * @return Verdadero si el motor se activó, falso en caso contrario
+			 * estableciendo el valor de errno.
+			 */
+			bool enableUring( unsigned int entries = 256 );
+
+			/**
+			 * @brief Desactiva el motor io_uring y regresa a
+			 * sendto()/recvfrom().
+			 */
+			void disableUring( void ) noexcept;
+
 			//===============================================================
 			//							Operadores
 			//===============================================================
@@ -324,6 +686,54 @@ namespace reroman
 			 */
 			bool receive( ARPFrame &frame, reroman::HwAddr *sender = nullptr );
 
+			/**
+			 * @brief Procesa en lote todas las tramas disponibles.
+			 * @details Espera a lo más getTimeout() milisegundos a que haya
+			 * tramas disponibles y después invoca a \p handler por cada una de
+			 * las tramas de los bloques listos. Con el anillo de recepción
+			 * activo las tramas se entregan sin copiarse.
+			 * @param handler Función a invocar por cada trama.
+			 * @return El número de tramas procesadas, 0 si terminó el tiempo de
+			 * espera.
+			 * @throw std::system_error si ocurriera algún error.
+			 * @see enableRxRing()
+			 */
+			std::size_t receiveRing( const FrameHandler &handler );
+
+			/**
+			 * @brief Procesa en lote todas las tramas disponibles sin
+			 * copiarlas, con cualquier longitud de dirección física.
+			 * @details Funciona como receiveRing(), pero entrega vistas sobre
+			 * las tramas en lugar de ARPFrame, por lo que también procesa
+			 * tramas de IP sobre InfiniBand. Con el anillo de recepción activo
+			 * las vistas apuntan directamente al anillo; sin él, cada trama se
+			 * lee en un buffer local, y con io_uring activo sólo se reciben
+			 * tramas Ethernet. Las tramas que no son ARP para IPv4 se
+			 * descartan. Para recibir tramas con direcciones de otra longitud
+			 * el filtro no debe usar ARPFilter::onlyEthernetIPv4.
+			 * @param handler Función a invocar por cada trama.
+			 * @return El número de tramas procesadas, 0 si terminó el tiempo de
+			 * espera.
+			 * @throw std::system_error si ocurriera algún error.
+			 * @see enableRxRing()
+			 */
+			std::size_t receiveViews( const FrameViewHandler &handler );
+
+			/**
+			 * @brief Recibe varias tramas ARP con una sola llamada al sistema.
+			 * @details Espera a lo más getTimeout() milisegundos por la primer
+			 * trama y después lee las que ya estén disponibles sin bloquear.
+			 * @param[out] frames Arreglo en el cual se almacenarán las tramas.
+			 * @param count Número de elementos de \p frames.
+			 * @param[out] senders Si no es null, arreglo de \p count elementos
+			 * en el cual se almacenarán las direcciones de los remitentes.
+			 * @return El número de tramas leídas, 0 si terminó el tiempo de
+			 * espera antes de leer algo.
+			 * @throw std::system_error si ocurriera algún error.
+			 */
+			std::size_t receiveBatch( ARPFrame *frames, std::size_t count,
+					reroman::HwAddr *senders = nullptr );
+
 			/**
 			 * @brief Envia una trama ARP.
 			 * @param frame La trama que se desea enviar.
@@ -335,6 +745,22 @@ namespace reroman
 			bool send( const ARPFrame &frame, const reroman::HwAddr &dest,
 				   const reroman::NetworkInterface &nic	);
 
+			/**
+			 * @brief Envía varias tramas ARP con una sola llamada al sistema.
+			 * @param frames Arreglo con las tramas que se desean enviar.
+			 * @param count Número de elementos de \p frames.
+			 * @param dest Dirección a la cual enviar las tramas.
+			 * @param nic Interfaz de red por la cual enviar las tramas.
+			 * @details Si el kernel acepta sólo una parte de un lote, el resto
+			 * se reintenta de inmediato, por lo que la función sólo se
+			 * detiene cuando un envío falla por completo.
+			 * @return El número de tramas enviadas. Si es menor a \p count
+			 * ocurrió un error y se cambia el valor de errno.
+			 */
+			std::size_t sendBatch( const ARPFrame *frames, std::size_t count,
+					const reroman::HwAddr &dest,
+					const reroman::NetworkInterface &nic );
+
 			/**
 			 * @brief Enlaza el socket a una interfaz de red (sólo para recibir).
 			 * @param nic Interfaz a la cual se desea enlazar el socket.
@@ -343,9 +769,59 @@ namespace reroman
 			 */
 			bool bind( const reroman::NetworkInterface &nic );
 
+			/**
+			 * @brief Agrega el socket a un grupo PACKET_FANOUT.
+			 * @details El kernel reparte las tramas recibidas entre los sockets
+			 * del grupo. Todos deben estar enlazados a la misma interfaz y usar
+			 * el mismo modo.
+			 * @param group Identificador del grupo.
+			 * @param mode Modo de distribución.
+			 * @return Verdadero si el socket se agregó al grupo, falso en caso
+			 * contrario estableciendo el valor de errno.
+			 */
+			bool joinFanout( uint16_t group, FanoutMode mode = FanoutMode::HASH );
+
+			/**
+			 * @brief Crea un grupo PACKET_FANOUT nuevo con este socket como
+			 * primer miembro.
+			 * @details El kernel asigna un identificador que no está en uso,
+			 * por lo que el grupo no se mezcla con los de otros procesos. El
+			 * resto de los sockets se agregan con joinFanout() usando el
+			 * identificador obtenido.
+			 * @param[out] group Identificador asignado al grupo.
+			 * @param mode Modo de distribución.
+			 * @return Verdadero si se creó el grupo, falso en caso contrario
+			 * estableciendo el valor de errno.
+			 */
+			bool createFanout( uint16_t &group, FanoutMode mode = FanoutMode::HASH );
+
+			/**
+			 * @brief Compila y asocia al socket un filtro BPF clásico.
+			 * @details Las tramas que esperaban ser leídas al momento de
+			 * asociar el filtro se descartan. Si la operación falla el
+			 * socket queda sin filtro.
+			 * @param filter Criterios que deben cumplir las tramas recibidas.
+			 * @return Verdadero si se asoció el filtro, falso en caso contrario
+			 * estableciendo el valor de errno.
+			 * @throw std::system_error si ocurre algún error al descartar las
+			 * tramas pendientes.
+			 */
+			bool setFilter( const ARPFilter &filter );
+
+			/**
+			 * @brief Elimina el filtro asociado al socket.
+			 * @return Verdadero si se eliminó el filtro, falso en caso contrario
+			 * estableciendo el valor de errno.
+			 */
+			bool clearFilter( void );
+
 
 			/**
 			 * @brief Resuelve una dirección IP utilizando el protocolo.
+			 * @details Después de enviar la petición se leen y descartan las
+			 * tramas que no son la respuesta esperada hasta recibirla o hasta
+			 * que transcurra el tiempo de espera, el cual se toma como el
+			 * tiempo total de la operación y no por cada lectura.
 			 * @param ip Dirección IP que se desea resolver.
 			 * @param nic Interfaz de red a utilizar.
 			 * @param[out] result Si no es null, almacena la dirección física
@@ -358,9 +834,51 @@ namespace reroman
 					const reroman::NetworkInterface &nic,
 					reroman::HwAddr *result = nullptr );
 
+			/**
+			 * @brief Resuelve un conjunto de direcciones IP de forma concurrente.
+			 * @details Mantiene hasta \p window peticiones pendientes a la vez,
+			 * enviando nuevas peticiones conforme llegan respuestas o expiran
+			 * las anteriores. Cada petición espera a lo más getTimeout()
+			 * milisegundos, por lo que el tiempo total es aproximadamente el
+			 * tiempo de envío más un tiempo de espera. Si el tiempo de espera
+			 * es 0 cada petición espera indefinidamente.
+			 * @param targets Direcciones IP que se desean resolver. Las
+			 * direcciones repetidas se resuelven una sola vez.
+			 * @param nic Interfaz de red a utilizar.
+			 * @param handler Función invocada en cuanto llega la respuesta de
+			 * cada dirección.
+			 * @param window Número máximo de peticiones pendientes.
+			 * @return El número de direcciones resueltas.
+			 * @throw std::system_error si ocurre algún error.
+			 */
+			std::size_t resolveMany( const std::vector<reroman::IPv4Addr> &targets,
+					const reroman::NetworkInterface &nic,
+					const ResolveHandler &handler,
+					std::size_t window = 256 );
+
 		private:
 			int sock;
 			struct timeval timer;
+			unsigned int discarded = 0;
+			bool nonBlocking = false;
+
+			uint8_t *ring = nullptr;
+			std::size_t ringBlockSize = 0;
+			std::size_t ringBlockCount = 0;
+			std::size_t ringBlock = 0;
+			uint8_t *ringPacket = nullptr;
+			uint32_t ringPending = 0;
+
+			struct Uring;
+			Uring *uring = nullptr;
+
+			bool nextFrame( ARPFrame &frame, struct ::sockaddr_ll &sll );
+			uint8_t* readyBlock( void ) noexcept;
+			void releaseBlock( void ) noexcept;
+			bool uringNext( ARPFrame &frame, struct ::sockaddr_ll &sll );
+			std::size_t uringSend( const ARPFrame *frames, std::size_t count,
+					const reroman::HwAddr &dst,
+					const reroman::NetworkInterface &nic );
 		};
 
 
@@ -465,11 +983,176 @@ namespace reroman
 		}
 
 
+		template <uint8_t HwLen>
+		inline BasicARPFrameView<HwLen>::BasicARPFrameView( const void *data,
+				std::size_t len ) noexcept
+		{
+			const uint8_t *bytes = static_cast<const uint8_t*>( data );
+
+			if( len < HeaderLen )
+				return;
+
+			const uint8_t hw = bytes[4];
+			if( ( HwLen ? hw == HwLen : hw != 0 ) &&
+					bytes[5] == IPv4Addr::IPv4AddrLen &&
+					bytes[2] == 0x08 && bytes[3] == 0x00 &&
+					len >= HeaderLen + 2 * ( hw + IPv4Addr::IPv4AddrLen ) )
+				this->data = bytes;
+		}
+
+		template <uint8_t HwLen>
+		inline uint8_t BasicARPFrameView<HwLen>::hwLen( void ) const noexcept
+		{
+			return HwLen ? HwLen : data[4];
+		}
+
+		template <uint8_t HwLen>
+		inline uint32_t BasicARPFrameView<HwLen>::readIPv4( std::size_t offset )
+			const noexcept
+		{
+			uint32_t value;
+
+			std::memcpy( &value, data + offset, sizeof(value) );
+			return value;
+		}
+
+		template <uint8_t HwLen>
+		inline bool BasicARPFrameView<HwLen>::isValid( void ) const noexcept
+		{
+			return data;
+		}
+
+		template <uint8_t HwLen>
+		inline BasicARPFrameView<HwLen>::operator bool( void ) const noexcept
+		{
+			return data;
+		}
+
+		template <uint8_t HwLen>
+		inline const uint8_t* BasicARPFrameView<HwLen>::getData( void ) const noexcept
+		{
+			return data;
+		}
+
+		template <uint8_t HwLen>
+		inline std::size_t BasicARPFrameView<HwLen>::getSize( void ) const noexcept
+		{
+			return HeaderLen + 2 * ( hwLen() + IPv4Addr::IPv4AddrLen );
+		}
+
+		template <uint8_t HwLen>
+		inline HwType BasicARPFrameView<HwLen>::getHwType( void ) const noexcept
+		{
+			return static_cast<HwType>( data[0] << 8 | data[1] );
+		}
+
+		template <uint8_t HwLen>
+		inline Protocol BasicARPFrameView<HwLen>::getProtocol( void ) const noexcept
+		{
+			return static_cast<Protocol>( data[2] << 8 | data[3] );
+		}
+
+		template <uint8_t HwLen>
+		inline uint8_t BasicARPFrameView<HwLen>::getHwLen( void ) const noexcept
+		{
+			return hwLen();
+		}
+
+		template <uint8_t HwLen>
+		inline uint8_t BasicARPFrameView<HwLen>::getProtocolLen( void ) const noexcept
+		{
+			return IPv4Addr::IPv4AddrLen;
+		}
+
+		template <uint8_t HwLen>
+		inline OperationCode BasicARPFrameView<HwLen>::getOpCode( void ) const noexcept
+		{
+			return static_cast<OperationCode>( data[6] << 8 | data[7] );
+		}
+
+		template <uint8_t HwLen>
+		inline const uint8_t* BasicARPFrameView<HwLen>::getSourceHw( void ) const noexcept
+		{
+			return data + HeaderLen;
+		}
+
+		template <uint8_t HwLen>
+		inline const uint8_t* BasicARPFrameView<HwLen>::getTargetHw( void ) const noexcept
+		{
+			return data + HeaderLen + hwLen() + IPv4Addr::IPv4AddrLen;
+		}
+
+		template <uint8_t HwLen>
+		inline HwAddr BasicARPFrameView<HwLen>::getSourceHwAddr( void ) const noexcept
+		{
+			static_assert( HwLen == HwAddr::HwAddrLen,
+					"HwAddr only holds 6-byte hardware addresses" );
+			return reroman::HwAddr( getSourceHw() );
+		}
+
+		template <uint8_t HwLen>
+		inline HwAddr BasicARPFrameView<HwLen>::getTargetHwAddr( void ) const noexcept
+		{
+			static_assert( HwLen == HwAddr::HwAddrLen,
+					"HwAddr only holds 6-byte hardware addresses" );
+			return reroman::HwAddr( getTargetHw() );
+		}
+
+		template <uint8_t HwLen>
+		inline IPv4Addr BasicARPFrameView<HwLen>::getSourceIPAddr( void ) const noexcept
+		{
+			return reroman::IPv4Addr( readIPv4( HeaderLen + hwLen() ) );
+		}
+
+		template <uint8_t HwLen>
+		inline IPv4Addr BasicARPFrameView<HwLen>::getTargetIPAddr( void ) const noexcept
+		{
+			return reroman::IPv4Addr( readIPv4( HeaderLen + 2 * hwLen() +
+						IPv4Addr::IPv4AddrLen ) );
+		}
+
+		template <uint8_t HwLen>
+		template <uint8_t Len>
+		inline BasicARPFrameView<Len> BasicARPFrameView<HwLen>::as( void ) const noexcept
+		{
+			return data ? BasicARPFrameView<Len>( data, getSize() ) :
+				BasicARPFrameView<Len>();
+		}
+
+		template <uint8_t HwLen>
+		constexpr std::size_t BasicARPFrameView<HwLen>::HeaderLen;
+
+
 		inline int ARPSocket::getTimeout( void ) const noexcept
 		{
 			return timer.tv_sec * 1000 +
 				timer.tv_usec / 1000;
 		}
+
+		inline unsigned int ARPSocket::getDiscardedFrames( void ) const noexcept
+		{
+			return discarded;
+		}
+
+		inline bool ARPSocket::isRxRingEnabled( void ) const noexcept
+		{
+			return ring;
+		}
+
+		inline int ARPSocket::getNativeHandle( void ) const noexcept
+		{
+			return sock;
+		}
+
+		inline bool ARPSocket::isUringEnabled( void ) const noexcept
+		{
+			return uring;
+		}
+
+		inline bool ARPSocket::isNonBlocking( void ) const noexcept
+		{
+			return nonBlocking;
+		}
 	} // namespace arp
 } // namespace reroman
 
@@ -0,0 +1,163 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of the  nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @file
+ * @author Ricardo Román <reroman4@gmail.com>
+ * @brief Declaración de la clase reroman::arp::ARPBulkSender.
+ */
+
+#ifndef REROMAN_ARPBULKSENDER_HPP
+#define REROMAN_ARPBULKSENDER_HPP
+
+#include <reroman/arp/arp.hpp>
+#include <vector>
+
+namespace reroman
+{
+	namespace arp
+	{
+		/**
+		 * @brief Envía peticiones ARP en lote mediante un anillo PACKET_TX_RING.
+		 * @details Todas las ranuras del anillo se llenan una sola vez con una
+		 * petición broadcast construida a partir de la interfaz de red; por cada
+		 * petición encolada sólo se modifica la dirección IP destino. Las
+		 * peticiones encoladas se envían con una sola llamada al sistema. Las
+		 * respuestas deben leerse con un ARPSocket.
+		 * @headerfile arpbulksender.hpp <reroman/arp/arpbulksender.hpp>
+		 */
+		class ARPBulkSender final
+		{
+		public:
+			//===============================================================
+			//							Constructores
+			//===============================================================
+			/**
+			 * @brief Abre un socket de envío asociado a una interfaz de red.
+			 * @details Sólo procesos con id de usuario efectivo 0 o capacidad
+			 * CAP_NET_RAW pueden crear este tipo de sockets.
+			 * @param nic Interfaz de red por la cual enviar las peticiones.
+			 * @param frames Número mínimo de ranuras del anillo.
+			 * @param qdiscBypass Si es verdadero las tramas se entregan
+			 * directamente al controlador sin pasar por la disciplina de
+			 * colas (PACKET_QDISC_BYPASS).
+			 * @throw std::system_error si no puede crearse el anillo.
+			 */
+			explicit ARPBulkSender( const reroman::NetworkInterface &nic,
+					unsigned int frames = 4096, bool qdiscBypass = false );
+
+			ARPBulkSender( const ARPBulkSender& ) = delete;
+			ARPBulkSender& operator=( const ARPBulkSender& ) = delete;
+
+			~ARPBulkSender();
+
+
+			//===============================================================
+			//							Getters
+			//===============================================================
+			/**
+			 * @brief Obtiene el número de ranuras del anillo.
+			 */
+			std::size_t getCapacity( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene el número de peticiones encoladas que no se han
+			 * enviado.
+			 */
+			std::size_t getQueued( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene el número de tramas que el kernel rechazó por
+			 * tener un formato inválido.
+			 * @details Las ranuras rechazadas se reutilizan conforme se
+			 * encolan nuevas peticiones, momento en el que se contabilizan.
+			 */
+			std::size_t getErrors( void ) const noexcept;
+
+
+			//===============================================================
+			//							Operaciones
+			//===============================================================
+			/**
+			 * @brief Encola una petición ARP para una dirección IP.
+			 * @param ip Dirección IP que se desea resolver.
+			 * @return Verdadero si la petición se encoló, falso si el anillo
+			 * está lleno y es necesario llamar a flush().
+			 */
+			bool queue( const reroman::IPv4Addr &ip ) noexcept;
+
+			/**
+			 * @brief Envía todas las peticiones encoladas.
+			 * @details Espera a que el kernel termine de transmitir las tramas.
+			 * @return El número de peticiones enviadas.
+			 * @throw std::system_error si ocurre algún error.
+			 */
+			std::size_t flush( void );
+
+			/**
+			 * @brief Envía una petición ARP por cada dirección IP.
+			 * @param targets Direcciones IP que se desean resolver.
+			 * @return El número de peticiones enviadas.
+			 * @throw std::system_error si ocurre algún error.
+			 */
+			std::size_t probe( const std::vector<reroman::IPv4Addr> &targets );
+
+		private:
+			int sock;
+			uint8_t *ring;
+			std::size_t ringSize;
+			std::size_t frameSize;
+			std::size_t frameCount;
+			std::size_t head = 0;
+			std::size_t queued = 0;
+			std::size_t errors = 0;
+		};
+
+
+		//===============================================================
+		//					Métodos Inline	
+		//===============================================================
+		inline std::size_t ARPBulkSender::getCapacity( void ) const noexcept
+		{
+			return frameCount;
+		}
+
+		inline std::size_t ARPBulkSender::getQueued( void ) const noexcept
+		{
+			return queued;
+		}
+
+		inline std::size_t ARPBulkSender::getErrors( void ) const noexcept
+		{
+			return errors;
+		}
+	} // namespace arp
+} // namespace reroman
+
+#endif // REROMAN_ARPBULKSENDER_HPP
@@ -0,0 +1,194 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of the  nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @file
+ * @author Ricardo Román <reroman4@gmail.com>
+ * @brief Operaciones ARP asíncronas para corrutinas de C++20.
+ * @details Este archivo sólo declara algo si se compila con soporte para
+ * corrutinas (C++20); la biblioteca en sí sigue requiriendo sólo C++11.
+ */
+
+#ifndef REROMAN_ARPCORO_HPP
+#define REROMAN_ARPCORO_HPP
+
+#include <reroman/arp/arpreactor.hpp>
+
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace reroman
+{
+	namespace arp
+	{
+		/**
+		 * @brief Tipo de retorno para corrutinas que no se esperan.
+		 * @details La corrutina inicia inmediatamente y libera su estado al
+		 * terminar. Una excepción no atrapada termina el programa.
+		 * @headerfile arpcoro.hpp <reroman/arp/arpcoro.hpp>
+		 */
+		struct ARPTask
+		{
+			struct promise_type
+			{
+				ARPTask get_return_object( void ) noexcept { return {}; }
+				std::suspend_never initial_suspend( void ) noexcept { return {}; }
+				std::suspend_never final_suspend( void ) noexcept { return {}; }
+				void return_void( void ) noexcept {}
+				void unhandled_exception( void ) noexcept { std::terminate(); }
+			};
+		};
+
+		/**
+		 * @brief Operación esperable que resuelve una dirección IP.
+		 * @see resolveAsync()
+		 * @headerfile arpcoro.hpp <reroman/arp/arpcoro.hpp>
+		 */
+		class ResolveAwaitable
+		{
+		public:
+			ResolveAwaitable( ARPReactor &loop, ARPSocket &sock,
+					const reroman::IPv4Addr &ip,
+					const reroman::NetworkInterface &nic )
+				: loop( loop ), sock( sock ), ip( ip ), nic( nic ){}
+
+			bool await_ready( void ) const noexcept
+			{
+				return false;
+			}
+
+			bool await_suspend( std::coroutine_handle<> handle )
+			{
+				// Si la petición no pudo enviarse la corrutina continúa
+				return loop.resolve( sock, ip, nic,
+						[this, handle]( const reroman::IPv4Addr&,
+							const reroman::HwAddr *hw ){
+							if( hw )
+								result = *hw;
+							handle.resume();
+						} );
+			}
+
+			std::optional<reroman::HwAddr> await_resume( void ) noexcept
+			{
+				return std::move( result );
+			}
+
+		private:
+			ARPReactor &loop;
+			ARPSocket &sock;
+			reroman::IPv4Addr ip;
+			const reroman::NetworkInterface &nic;
+			std::optional<reroman::HwAddr> result;
+		};
+
+		/**
+		 * @brief Operación esperable que recibe una trama ARP.
+		 * @see receiveAsync()
+		 * @headerfile arpcoro.hpp <reroman/arp/arpcoro.hpp>
+		 */
+		class ReceiveAwaitable
+		{
+		public:
+			ReceiveAwaitable( ARPReactor &loop, ARPSocket &sock )
+				: loop( loop ), sock( sock ){}
+
+			bool await_ready( void ) const noexcept
+			{
+				return false;
+			}
+
+			bool await_suspend( std::coroutine_handle<> handle )
+			{
+				return loop.receive( sock,
+						[this, handle]( const ARPFrame *frame,
+							const reroman::HwAddr *sender ){
+							if( frame )
+								result.emplace( *frame, *sender );
+							handle.resume();
+						} );
+			}
+
+			std::optional<std::pair<ARPFrame, reroman::HwAddr>>
+				await_resume( void ) noexcept
+			{
+				return std::move( result );
+			}
+
+		private:
+			ARPReactor &loop;
+			ARPSocket &sock;
+			std::optional<std::pair<ARPFrame, reroman::HwAddr>> result;
+		};
+
+		/**
+		 * @brief Resuelve una dirección IP suspendiendo la corrutina.
+		 * @details La corrutina se reanuda desde el ciclo de eventos al llegar
+		 * la respuesta o al transcurrir el tiempo de espera del socket.
+		 * @code
+		 * auto hw = co_await resolveAsync( loop, sock, ip, nic );
+		 * if( hw )
+		 *     std::cout << ip << " -> " << *hw << std::endl;
+		 * @endcode
+		 * @param loop Ciclo de eventos en el cual está registrado \p sock.
+		 * @param sock Socket por el cual enviar la petición.
+		 * @param ip Dirección IP que se desea resolver.
+		 * @param nic Interfaz de red a utilizar. Debe existir hasta que la
+		 * operación termine.
+		 * @return Una operación esperable cuyo resultado es la dirección
+		 * física, o vacío si no hubo respuesta.
+		 */
+		inline ResolveAwaitable resolveAsync( ARPReactor &loop, ARPSocket &sock,
+				const reroman::IPv4Addr &ip, const reroman::NetworkInterface &nic )
+		{
+			return ResolveAwaitable( loop, sock, ip, nic );
+		}
+
+		/**
+		 * @brief Recibe la siguiente trama de un socket suspendiendo la
+		 * corrutina.
+		 * @param loop Ciclo de eventos en el cual está registrado \p sock.
+		 * @param sock Socket del cual recibir la trama.
+		 * @return Una operación esperable cuyo resultado es la trama y la
+		 * dirección del remitente, o vacío si terminó el tiempo de espera.
+		 */
+		inline ReceiveAwaitable receiveAsync( ARPReactor &loop, ARPSocket &sock )
+		{
+			return ReceiveAwaitable( loop, sock );
+		}
+	} // namespace arp
+} // namespace reroman
+
+#endif // Soporte para corrutinas
+
+#endif // REROMAN_ARPCORO_HPP
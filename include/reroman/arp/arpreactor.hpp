@@ -0,0 +1,280 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of the  nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @file
+ * @author Ricardo Román <reroman4@gmail.com>
+ * @brief Declaración de la clase reroman::arp::ARPReactor.
+ */
+
+#ifndef REROMAN_ARPREACTOR_HPP
+#define REROMAN_ARPREACTOR_HPP
+
+#include <reroman/arp/arp.hpp>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace reroman
+{
+	namespace arp
+	{
+		/**
+		 * @brief Ciclo de eventos basado en epoll para varios ARPSocket.
+		 * @details Multiplexa sockets y temporizadores en una sola instancia
+		 * de epoll, de modo que un solo hilo puede atender la resolución de
+		 * direcciones en todas las interfaces de red. Los métodos deben
+		 * invocarse desde el hilo que ejecuta el ciclo.
+		 * @headerfile arpreactor.hpp <reroman/arp/arpreactor.hpp>
+		 */
+		class ARPReactor final
+		{
+		public:
+			/**
+			 * @brief Identificador de un temporizador.
+			 */
+			typedef uint64_t TimerId;
+
+			/**
+			 * @brief Función a invocar al expirar un temporizador.
+			 */
+			using TimerHandler = std::function<void( void )>;
+
+			/**
+			 * @brief Función a invocar al terminar una resolución asíncrona.
+			 * @details Recibe la dirección IP solicitada y un apuntador a la
+			 * dirección física asociada, o null si terminó el tiempo de espera.
+			 */
+			using ResolveCallback = std::function<void( const reroman::IPv4Addr&,
+				  const reroman::HwAddr* )>;
+
+			/**
+			 * @brief Función a invocar al terminar una recepción asíncrona.
+			 * @details Recibe la trama y la dirección del remitente, o null en
+			 * ambos si terminó el tiempo de espera.
+			 */
+			using ReceiveCallback = std::function<void( const ARPFrame*,
+				  const reroman::HwAddr* )>;
+
+			//===============================================================
+			//							Constructores
+			//===============================================================
+			/**
+			 * @brief Crea un ciclo de eventos vacío.
+			 * @throw std::system_error si no puede crearse la instancia de epoll.
+			 */
+			ARPReactor( void );
+
+			ARPReactor( const ARPReactor& ) = delete;
+			ARPReactor& operator=( const ARPReactor& ) = delete;
+
+			~ARPReactor();
+
+
+			//===============================================================
+			//							Getters
+			//===============================================================
+			/**
+			 * @brief Obtiene el descriptor de la instancia de epoll.
+			 * @details Permite anidar el reactor en otro ciclo de eventos: cuando
+			 * el descriptor está listo para lectura basta con llamar a
+			 * runOnce( 0 ). Los temporizadores requieren llamar a runOnce()
+			 * al menos cada getNextTimeout() milisegundos.
+			 * @return El descriptor de archivo.
+			 */
+			int getNativeHandle( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene el tiempo que falta para que expire el siguiente
+			 * temporizador.
+			 * @return El tiempo en milisegundos, o -1 si no hay temporizadores.
+			 */
+			int getNextTimeout( void ) const;
+
+
+			//===============================================================
+			//							Operaciones
+			//===============================================================
+			/**
+			 * @brief Registra un socket en el ciclo de eventos.
+			 * @details El socket se cambia a modo no bloqueante. El objeto
+			 * debe existir mientras se encuentre registrado y los anillos o
+			 * el motor io_uring deben activarse antes de registrarlo.
+			 * @param sock Socket a registrar.
+			 * @param handler Si no es vacía, función a invocar por cada trama
+			 * recibida en el socket.
+			 * @return Verdadero si se registró el socket, falso en caso
+			 * contrario estableciendo el valor de errno.
+			 */
+			bool add( ARPSocket &sock,
+					ARPSocket::FrameHandler handler = nullptr );
+
+			/**
+			 * @brief Elimina un socket del ciclo de eventos.
+			 * @details Las resoluciones pendientes en el socket se descartan
+			 * sin invocar sus funciones.
+			 * @param sock Socket a eliminar.
+			 * @return Verdadero si se eliminó, falso si no estaba registrado.
+			 */
+			bool remove( ARPSocket &sock );
+
+			/**
+			 * @brief Registra un descriptor de archivo cualquiera en el ciclo
+			 * de eventos.
+			 * @details Permite atender en el mismo hilo otras fuentes de
+			 * eventos, como NeighborMonitor. La notificación es por nivel, así
+			 * que \p handler debe leer todos los datos disponibles.
+			 * @param fd Descriptor a registrar.
+			 * @param handler Función a invocar cuando el descriptor esté listo
+			 * para lectura.
+			 * @return Verdadero si se registró el descriptor, falso en caso
+			 * contrario estableciendo el valor de errno.
+			 */
+			bool add( int fd, std::function<void( void )> handler );
+
+			/**
+			 * @brief Elimina un descriptor registrado con add( int, ... ).
+			 * @param fd Descriptor a eliminar.
+			 * @return Verdadero si se eliminó, falso si no estaba registrado.
+			 */
+			bool remove( int fd );
+
+			/**
+			 * @brief Programa un temporizador de un solo disparo.
+			 * @param msecs Tiempo en milisegundos antes de invocar a \p handler.
+			 * @param handler Función a invocar.
+			 * @return El identificador del temporizador.
+			 */
+			TimerId addTimer( unsigned int msecs, TimerHandler handler );
+
+			/**
+			 * @brief Cancela un temporizador.
+			 * @param id Identificador del temporizador.
+			 * @return Verdadero si se canceló, falso si ya había expirado.
+			 */
+			bool cancelTimer( TimerId id );
+
+			/**
+			 * @brief Resuelve una dirección IP sin bloquear.
+			 * @details Envía la petición y regresa inmediatamente; \p callback
+			 * se invoca desde el ciclo de eventos al recibir la respuesta o al
+			 * transcurrir el tiempo de espera del socket.
+			 * @param sock Socket registrado por el cual enviar la petición.
+			 * @param ip Dirección IP que se desea resolver.
+			 * @param nic Interfaz de red a utilizar.
+			 * @param callback Función a invocar con el resultado.
+			 * @return Verdadero si se envió la petición, falso en caso contrario
+			 * estableciendo el valor de errno.
+			 */
+			bool resolve( ARPSocket &sock, const reroman::IPv4Addr &ip,
+					const reroman::NetworkInterface &nic,
+					ResolveCallback callback );
+
+			/**
+			 * @brief Espera la siguiente trama en un socket sin bloquear.
+			 * @details \p callback se invoca desde el ciclo de eventos con la
+			 * siguiente trama recibida en el socket, o al transcurrir el tiempo
+			 * de espera del socket.
+			 * @param sock Socket registrado del cual recibir la trama.
+			 * @param callback Función a invocar con el resultado.
+			 * @return Verdadero si se registró la espera, falso si el socket no
+			 * está registrado.
+			 */
+			bool receive( ARPSocket &sock, ReceiveCallback callback );
+
+			/**
+			 * @brief Espera eventos una vez y los atiende.
+			 * @param msecs Tiempo máximo de espera en milisegundos. Un valor
+			 * negativo espera hasta el siguiente evento o temporizador.
+			 * @return El número de eventos atendidos.
+			 * @throw std::system_error si ocurre algún error.
+			 */
+			std::size_t runOnce( int msecs = -1 );
+
+			/**
+			 * @brief Atiende eventos hasta que se llame a stop() o no haya
+			 * sockets ni temporizadores registrados.
+			 * @throw std::system_error si ocurre algún error.
+			 */
+			void run( void );
+
+			/**
+			 * @brief Detiene run() al terminar la iteración actual.
+			 */
+			void stop( void ) noexcept;
+
+		private:
+			typedef std::chrono::steady_clock Clock;
+
+			struct Pending
+			{
+				ResolveCallback callback;
+				TimerId timer;
+			};
+
+			struct Waiter
+			{
+				ReceiveCallback callback;
+				TimerId timer;
+			};
+
+			int epfd;
+			bool stopped = false;
+			TimerId nextTimer = 1;
+			std::unordered_map<int,
+				std::shared_ptr<std::function<void( void )>>> handles;
+			std::map<std::pair<Clock::time_point, TimerId>, TimerHandler> timers;
+			std::unordered_map<TimerId, Clock::time_point> timerIndex;
+			std::unordered_multimap<uint64_t, Pending> pending;
+			std::unordered_map<int, std::vector<Waiter>> waiters;
+
+			void dispatch( int fd, const ARPFrame &frame, const HwAddr &sender );
+			std::size_t expireTimers( void );
+		};
+
+
+		//===============================================================
+		//					Métodos Inline	
+		//===============================================================
+		inline int ARPReactor::getNativeHandle( void ) const noexcept
+		{
+			return epfd;
+		}
+
+		inline void ARPReactor::stop( void ) noexcept
+		{
+			stopped = true;
+		}
+	} // namespace arp
+} // namespace reroman
+
+#endif // REROMAN_ARPREACTOR_HPP
@@ -0,0 +1,169 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of the  nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @file
+ * @author Ricardo Román <reroman4@gmail.com>
+ * @brief Declaración de la clase reroman::arp::ARPReceiverGroup.
+ */
+
+#ifndef REROMAN_ARPRECEIVERGROUP_HPP
+#define REROMAN_ARPRECEIVERGROUP_HPP
+
+#include <reroman/arp/arp.hpp>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace reroman
+{
+	namespace arp
+	{
+		/**
+		 * @brief Recibe tramas ARP en paralelo con varios sockets unidos en un
+		 * grupo PACKET_FANOUT.
+		 * @details Cada socket es atendido por su propio hilo, opcionalmente
+		 * fijado a un CPU, y entrega las tramas a su propia función sin
+		 * compartir estado con los demás hilos.
+		 * @headerfile arpreceivergroup.hpp <reroman/arp/arpreceivergroup.hpp>
+		 */
+		class ARPReceiverGroup final
+		{
+		public:
+			/**
+			 * @brief Función que crea la función de atención de cada hilo.
+			 * @details Recibe el índice del hilo, de 0 a getSize() - 1.
+			 */
+			using HandlerFactory = std::function<ARPSocket::FrameHandler(
+					unsigned int )>;
+
+			//===============================================================
+			//							Constructores
+			//===============================================================
+			/**
+			 * @brief Abre los sockets del grupo y los enlaza a una interfaz.
+			 * @details Sólo procesos con id de usuario efectivo 0 o capacidad
+			 * CAP_NET_RAW pueden crear este tipo de sockets. Cada socket usa
+			 * un anillo de recepción si el kernel lo permite.
+			 * @param nic Interfaz de red de la cual recibir las tramas.
+			 * @param size Número de sockets e hilos. Si es 0 se usa el número
+			 * de CPUs del sistema.
+			 * @param mode Modo de distribución de tramas.
+			 * @throw std::system_error si no puede crearse el grupo.
+			 */
+			explicit ARPReceiverGroup( const reroman::NetworkInterface &nic,
+					unsigned int size = 0, FanoutMode mode = FanoutMode::HASH );
+
+			ARPReceiverGroup( const ARPReceiverGroup& ) = delete;
+			ARPReceiverGroup& operator=( const ARPReceiverGroup& ) = delete;
+
+			/**
+			 * @brief Detiene los hilos si continúan en ejecución.
+			 */
+			~ARPReceiverGroup();
+
+
+			//===============================================================
+			//							Getters
+			//===============================================================
+			/**
+			 * @brief Obtiene el número de sockets del grupo.
+			 */
+			unsigned int getSize( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene uno de los sockets del grupo.
+			 * @details Permite, por ejemplo, asociar un filtro a cada socket
+			 * antes de llamar a start().
+			 * @param index Índice del socket.
+			 * @throw std::out_of_range si index no es menor a getSize().
+			 */
+			ARPSocket& getSocket( unsigned int index );
+
+			/**
+			 * @brief Verifica si los hilos están en ejecución.
+			 */
+			bool isRunning( void ) const noexcept;
+
+
+			//===============================================================
+			//							Operaciones
+			//===============================================================
+			/**
+			 * @brief Inicia un hilo por socket.
+			 * @param factory Función invocada una vez por hilo para obtener
+			 * la función que atenderá sus tramas.
+			 * @param pin Si es verdadero el hilo i se fija al CPU i.
+			 * @throw std::logic_error si los hilos ya están en ejecución.
+			 */
+			void start( const HandlerFactory &factory, bool pin = true );
+
+			/**
+			 * @brief Detiene y espera a los hilos.
+			 * @details Los hilos terminan a lo más después del tiempo de
+			 * espera de sus sockets.
+			 * @throw Cualquier excepción no atrapada en alguno de los hilos.
+			 */
+			void stop( void );
+
+		private:
+			std::vector<std::unique_ptr<ARPSocket>> sockets;
+			std::vector<std::thread> threads;
+			std::atomic<bool> running;
+			std::mutex errorMutex;
+			std::exception_ptr error;
+
+			void join( void ) noexcept;
+		};
+
+
+		//===============================================================
+		//					Métodos Inline	
+		//===============================================================
+		inline unsigned int ARPReceiverGroup::getSize( void ) const noexcept
+		{
+			return sockets.size();
+		}
+
+		inline ARPSocket& ARPReceiverGroup::getSocket( unsigned int index )
+		{
+			return *sockets.at( index );
+		}
+
+		inline bool ARPReceiverGroup::isRunning( void ) const noexcept
+		{
+			return running;
+		}
+	} // namespace arp
+} // namespace reroman
+
+#endif // REROMAN_ARPRECEIVERGROUP_HPP
@@ -0,0 +1,211 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of the  nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @file
+ * @author Ricardo Román <reroman4@gmail.com>
+ * @brief Declaración de la clase reroman::arp::NeighborCache.
+ */
+
+#ifndef REROMAN_NEIGHBORCACHE_HPP
+#define REROMAN_NEIGHBORCACHE_HPP
+
+#include <reroman/arp/arp.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace reroman
+{
+	namespace arp
+	{
+		/**
+		 * @brief Resultado de una consulta a NeighborCache.
+		 */
+		enum class CacheStatus
+		{
+			MISS,		///< La dirección no se encuentra en la cache.
+			HIT,		///< Entrada vigente con dirección física.
+			NEGATIVE,	///< Entrada vigente de una dirección sin respuesta.
+			STALE		///< La entrada existe pero ya expiró.
+		};
+
+		/**
+		 * @brief Cache de resoluciones ARP en el proceso.
+		 * @details Guarda las direcciones resueltas durante un tiempo de vida
+		 * configurable y las direcciones que no respondieron durante un tiempo
+		 * menor. Las consultas no utilizan bloqueos: cada entrada se protege
+		 * con un contador de secuencia (seqlock), por lo que cualquier número
+		 * de hilos puede consultar mientras un solo escritor la actualiza.
+		 * Las escrituras y el uso del socket se serializan internamente.
+		 * @headerfile neighborcache.hpp <reroman/arp/neighborcache.hpp>
+		 */
+		class NeighborCache final
+		{
+		public:
+			/**
+			 * @brief Contadores de uso de la cache.
+			 */
+			struct Stats
+			{
+				uint64_t hits;			///< Consultas con entrada vigente.
+				uint64_t negativeHits;	///< Consultas con entrada negativa vigente.
+				uint64_t misses;		///< Consultas sin entrada.
+				uint64_t stale;			///< Consultas con entrada expirada.
+			};
+
+			//===============================================================
+			//							Constructores
+			//===============================================================
+			/**
+			 * @brief Crea una cache vacía.
+			 * @param sock Socket con el cual resolver las direcciones que no
+			 * se encuentran en la cache. Debe existir mientras exista la cache
+			 * y no debe utilizarse desde otros hilos.
+			 * @param nic Interfaz de red por la cual resolver.
+			 * @param ttl Tiempo de vida en ms de las entradas positivas.
+			 * @param negativeTtl Tiempo de vida en ms de las entradas negativas.
+			 * @param capacity Número máximo de entradas; se redondea a una
+			 * potencia de 2.
+			 */
+			NeighborCache( ARPSocket &sock, const reroman::NetworkInterface &nic,
+					unsigned int ttl = 60000, unsigned int negativeTtl = 5000,
+					std::size_t capacity = 4096 );
+
+			NeighborCache( const NeighborCache& ) = delete;
+			NeighborCache& operator=( const NeighborCache& ) = delete;
+
+			~NeighborCache();
+
+
+			//===============================================================
+			//							Getters
+			//===============================================================
+			/**
+			 * @brief Consulta la cache sin acceder a la red.
+			 * @details No utiliza bloqueos y puede invocarse desde cualquier hilo.
+			 * @param ip Dirección IP a consultar.
+			 * @param[out] result Si no es null y hay una entrada positiva,
+			 * almacena la dirección física aunque haya expirado.
+			 * @return El estado de la entrada.
+			 */
+			CacheStatus lookup( const reroman::IPv4Addr &ip,
+					reroman::HwAddr *result = nullptr ) const noexcept;
+
+			/**
+			 * @brief Obtiene los contadores de uso.
+			 */
+			Stats getStats( void ) const noexcept;
+
+
+			//===============================================================
+			//							Operaciones
+			//===============================================================
+			/**
+			 * @brief Resuelve una dirección IP utilizando la cache.
+			 * @details Si no hay una entrada vigente se resuelve con
+			 * ARPSocket::resolve() y se guarda el resultado, positivo o negativo.
+			 * @param ip Dirección IP a resolver.
+			 * @param[out] result Si no es null, almacena la dirección física.
+			 * @return Verdadero si la dirección tiene una dirección física
+			 * asociada, falso en caso contrario.
+			 * @throw std::system_error si ocurre algún error en el socket.
+			 */
+			bool resolve( const reroman::IPv4Addr &ip,
+					reroman::HwAddr *result = nullptr );
+
+			/**
+			 * @brief Guarda una entrada positiva.
+			 * @param ip Dirección IP.
+			 * @param hw Dirección física asociada.
+			 */
+			void insert( const reroman::IPv4Addr &ip, const reroman::HwAddr &hw );
+
+			/**
+			 * @brief Guarda una entrada negativa.
+			 * @param ip Dirección IP que no respondió.
+			 */
+			void insertNegative( const reroman::IPv4Addr &ip );
+
+			/**
+			 * @brief Marca la entrada de una dirección como expirada.
+			 * @param ip Dirección IP.
+			 */
+			void invalidate( const reroman::IPv4Addr &ip );
+
+			/**
+			 * @brief Inicia un hilo que renueva las entradas positivas antes
+			 * de que expiren.
+			 * @param ahead Anticipación en ms con la que se renueva una entrada.
+			 * @throw std::logic_error si la renovación ya está activa.
+			 */
+			void startRefresh( unsigned int ahead = 5000 );
+
+			/**
+			 * @brief Detiene el hilo de renovación.
+			 */
+			void stopRefresh( void );
+
+		private:
+			struct Slot
+			{
+				std::atomic<uint32_t> seq;
+				std::atomic<uint32_t> ip;
+				std::atomic<uint64_t> hw;
+				std::atomic<int64_t> expires;
+			};
+
+			ARPSocket &sock;
+			reroman::NetworkInterface nic;
+			const int64_t ttl;
+			const int64_t negativeTtl;
+			std::size_t mask;
+			std::unique_ptr<Slot[]> slots;
+
+			std::mutex writer;
+			std::thread refresher;
+			std::mutex refreshMutex;
+			std::condition_variable refreshCond;
+			bool refreshing = false;
+
+			mutable std::atomic<uint64_t> hits;
+			mutable std::atomic<uint64_t> negativeHits;
+			mutable std::atomic<uint64_t> misses;
+			mutable std::atomic<uint64_t> stale;
+
+			bool read( uint32_t ip, uint64_t &hw, int64_t &expires ) const noexcept;
+			void write( uint32_t ip, uint64_t hw, int64_t expires ) noexcept;
+			void refresh( unsigned int ahead );
+		};
+	} // namespace arp
+} // namespace reroman
+
+#endif // REROMAN_NEIGHBORCACHE_HPP
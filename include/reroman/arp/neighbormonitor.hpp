@@ -0,0 +1,185 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of the  nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @file
+ * @author Ricardo Román <reroman4@gmail.com>
+ * @brief Declaración de la clase reroman::arp::NeighborMonitor.
+ */
+
+#ifndef REROMAN_NEIGHBORMONITOR_HPP
+#define REROMAN_NEIGHBORMONITOR_HPP
+
+#include <reroman/arp/neighbortable.hpp>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace reroman
+{
+	namespace arp
+	{
+		/**
+		 * @brief Tipos de cambio en la tabla de vecinos del kernel.
+		 */
+		enum class NeighborEventType
+		{
+			ADDED,		///< Se creó una entrada.
+			CHANGED,	///< Cambió el estado o la dirección física de una entrada.
+			REMOVED		///< Se eliminó una entrada.
+		};
+
+		/**
+		 * @brief Cambio en la tabla de vecinos del kernel.
+		 */
+		struct NeighborEvent
+		{
+			NeighborEventType type;			///< Tipo de cambio.
+			NeighborEntry entry;			///< Entrada después del cambio.
+			reroman::NetworkInterface nic;	///< Interfaz de la entrada; no está
+											///< enlazada si ya no existe.
+		};
+
+		/**
+		 * @brief Recibe los cambios de la tabla de vecinos del kernel.
+		 * @details Se suscribe al grupo RTNLGRP_NEIGH de netlink y mantiene
+		 * una copia de la tabla para distinguir altas de modificaciones. Si el
+		 * socket se desborda durante una ráfaga de cambios, la copia se
+		 * sincroniza de nuevo con NeighborTable::dump() y se entregan las
+		 * diferencias, por lo que no se pierden transiciones netas.
+		 *
+		 * Para atender los cambios desde ARPReactor basta con registrar el
+		 * descriptor:
+		 * @code
+		 * reactor.add( monitor.getNativeHandle(), [&]( void ){
+		 *     monitor.poll( handler );
+		 * } );
+		 * @endcode
+		 * @headerfile neighbormonitor.hpp <reroman/arp/neighbormonitor.hpp>
+		 */
+		class NeighborMonitor final
+		{
+		public:
+			/**
+			 * @brief Función a invocar por cada cambio.
+			 */
+			using EventHandler = std::function<void( const NeighborEvent& )>;
+
+			//===============================================================
+			//							Constructores
+			//===============================================================
+			/**
+			 * @brief Se suscribe a los cambios y obtiene el estado inicial de
+			 * la tabla.
+			 * @throw std::system_error si no puede abrirse el socket.
+			 */
+			NeighborMonitor( void );
+
+			NeighborMonitor( const NeighborMonitor& ) = delete;
+			NeighborMonitor& operator=( const NeighborMonitor& ) = delete;
+
+			~NeighborMonitor();
+
+
+			//===============================================================
+			//							Getters
+			//===============================================================
+			/**
+			 * @brief Obtiene el descriptor del socket suscrito.
+			 * @details El socket es no bloqueante.
+			 * @return El descriptor de archivo.
+			 */
+			int getNativeHandle( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene el número de veces que se desbordó el socket.
+			 */
+			uint64_t getOverruns( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene la copia local de la tabla de vecinos IPv4.
+			 * @param[out] entries Contenedor donde se almacenan las entradas.
+			 */
+			void getEntries( std::vector<NeighborEntry> &entries ) const;
+
+
+			//===============================================================
+			//							Operaciones
+			//===============================================================
+			/**
+			 * @brief Entrega los cambios pendientes sin bloquear.
+			 * @details Lee los mensajes en lotes con recvmmsg() hasta vaciar
+			 * el socket.
+			 * @param handler Función a invocar por cada cambio.
+			 * @return El número de cambios entregados.
+			 * @throw std::system_error si ocurre algún error.
+			 */
+			std::size_t poll( const EventHandler &handler );
+
+			/**
+			 * @brief Espera cambios y los entrega.
+			 * @param handler Función a invocar por cada cambio.
+			 * @param msecs Tiempo máximo de espera en milisegundos. Un valor
+			 * negativo espera indefinidamente.
+			 * @return El número de cambios entregados, 0 si terminó el tiempo
+			 * de espera.
+			 * @throw std::system_error si ocurre algún error.
+			 */
+			std::size_t wait( const EventHandler &handler, int msecs = -1 );
+
+		private:
+			int sock;
+			uint64_t overruns = 0;
+			NeighborTable table;
+			std::vector<char> buffer;
+			std::unordered_map<uint64_t, NeighborEntry> known;
+			std::unordered_map<int, reroman::NetworkInterface> nics;
+
+			void emit( NeighborEventType type, const NeighborEntry &entry,
+					const EventHandler &handler );
+			std::size_t resync( const EventHandler *handler );
+		};
+
+
+		//===============================================================
+		//					Métodos Inline	
+		//===============================================================
+		inline int NeighborMonitor::getNativeHandle( void ) const noexcept
+		{
+			return sock;
+		}
+
+		inline uint64_t NeighborMonitor::getOverruns( void ) const noexcept
+		{
+			return overruns;
+		}
+	} // namespace arp
+} // namespace reroman
+
+#endif // REROMAN_NEIGHBORMONITOR_HPP
@@ -0,0 +1,275 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of the  nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @file
+ * @author Ricardo Román <reroman4@gmail.com>
+ * @brief Declaración de la clase reroman::arp::NeighborTable.
+ */
+
+#ifndef REROMAN_NEIGHBORTABLE_HPP
+#define REROMAN_NEIGHBORTABLE_HPP
+
+#include <reroman/arp/arp.hpp>
+#include <functional>
+#include <vector>
+
+struct nlmsghdr;
+
+
+namespace reroman
+{
+	namespace arp
+	{
+		class NeighborMonitor;
+
+		/**
+		 * @brief Estados de una entrada en la tabla de vecinos del kernel.
+		 * @details Equivalen a las constantes NUD_* y pueden combinarse como
+		 * máscara de bits.
+		 */
+		enum class NeighborState: uint16_t
+		{
+			NONE		=	0x00,	///< Sin estado.
+			INCOMPLETE	=	0x01,	///< Resolución en curso.
+			REACHABLE	=	0x02,	///< Confirmada recientemente.
+			STALE		=	0x04,	///< Válida pero sin confirmar.
+			DELAY		=	0x08,	///< Esperando confirmación.
+			PROBE		=	0x10,	///< Confirmando con peticiones.
+			FAILED		=	0x20,	///< La resolución falló.
+			NOARP		=	0x40,	///< No requiere resolución.
+			PERMANENT	=	0x80	///< Entrada estática.
+		};
+
+		/**
+		 * @brief Entrada de la tabla de vecinos del kernel.
+		 */
+		struct NeighborEntry
+		{
+			reroman::IPv4Addr ip;	///< Dirección IP del vecino.
+			reroman::HwAddr hw;		///< Dirección física, nula si no se conoce.
+			int ifindex = 0;		///< Índice de la interfaz de red.
+			uint16_t state = 0;		///< Combinación de valores NeighborState.
+			uint8_t flags = 0;		///< Banderas NTF_* de la entrada.
+			uint32_t probes = 0;	///< Peticiones enviadas sin respuesta.
+			uint32_t confirmed = 0;	///< Ms desde la última confirmación.
+			uint32_t used = 0;		///< Ms desde el último uso.
+			uint32_t updated = 0;	///< Ms desde la última actualización.
+		};
+
+		/**
+		 * @brief Acceso a la tabla de vecinos (cache ARP) del kernel por
+		 * medio de netlink.
+		 * @details A diferencia de getSystemEntry(), que requiere una llamada
+		 * al sistema por dirección, la tabla completa se obtiene en una sola
+		 * petición cuyas respuestas se procesan conforme llegan. Del mismo
+		 * modo, las modificaciones se acumulan y se envían juntas con commit(),
+		 * obteniendo el resultado de cada una.
+		 * @headerfile neighbortable.hpp <reroman/arp/neighbortable.hpp>
+		 */
+		class NeighborTable final
+		{
+		public:
+			/**
+			 * @brief Función a invocar por cada entrada de la tabla.
+			 */
+			using EntryHandler = std::function<void( const NeighborEntry& )>;
+
+			//===============================================================
+			//							Constructores
+			//===============================================================
+			/**
+			 * @brief Abre un socket netlink de enrutamiento.
+			 * @throw std::system_error si no puede abrirse el socket.
+			 */
+			NeighborTable( void );
+
+			NeighborTable( const NeighborTable& ) = delete;
+			NeighborTable& operator=( const NeighborTable& ) = delete;
+
+			~NeighborTable();
+
+
+			//===============================================================
+			//							Getters
+			//===============================================================
+			/**
+			 * @brief Obtiene el descriptor del socket netlink.
+			 * @return El descriptor de archivo.
+			 */
+			int getNativeHandle( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene el número de modificaciones pendientes de enviar.
+			 */
+			std::size_t getQueued( void ) const noexcept;
+
+
+			//===============================================================
+			//							Operaciones
+			//===============================================================
+			/**
+			 * @brief Recorre las entradas IPv4 de la tabla de vecinos.
+			 * @param handler Función a invocar por cada entrada.
+			 * @param ifindex Si no es 0, sólo se incluyen las entradas de la
+			 * interfaz con este índice.
+			 * @param states Máscara de valores NeighborState; sólo se incluyen
+			 * las entradas cuyo estado tenga algún bit en común con ella.
+			 * @return El número de entradas entregadas.
+			 * @throw std::system_error si ocurre algún error.
+			 */
+			std::size_t dump( const EntryHandler &handler, int ifindex = 0,
+					uint16_t states = 0xffff );
+
+			/**
+			 * @brief Obtiene las entradas IPv4 de la tabla de vecinos.
+			 * @details El contenedor se vacía sin liberar su memoria, por lo
+			 * que reservarla de antemano evita asignaciones durante la lectura.
+			 * @param[out] entries Contenedor donde se almacenan las entradas.
+			 * @param ifindex Si no es 0, sólo se incluyen las entradas de la
+			 * interfaz con este índice.
+			 * @param states Máscara de valores NeighborState.
+			 * @return El número de entradas obtenidas.
+			 * @throw std::system_error si ocurre algún error.
+			 */
+			std::size_t dump( std::vector<NeighborEntry> &entries,
+					int ifindex = 0, uint16_t states = 0xffff );
+
+			/**
+			 * @brief Agrega a la petición actual la creación de una entrada.
+			 * @details La operación falla con EEXIST si la entrada ya existe.
+			 * Modificar la tabla requiere permisos de superusuario.
+			 * @param nic Interfaz de red de la entrada.
+			 * @param ip Dirección IP de la entrada.
+			 * @param hw Dirección física asociada.
+			 * @param state Estado de la entrada.
+			 * @throw std::invalid_argument si la interfaz de red no es válida.
+			 */
+			void queueAdd( const reroman::NetworkInterface &nic,
+					const reroman::IPv4Addr &ip, const reroman::HwAddr &hw,
+					NeighborState state = NeighborState::PERMANENT );
+
+			/**
+			 * @brief Agrega a la petición actual la creación o reemplazo de una
+			 * entrada.
+			 * @param nic Interfaz de red de la entrada.
+			 * @param ip Dirección IP de la entrada.
+			 * @param hw Dirección física asociada.
+			 * @param state Estado de la entrada.
+			 * @throw std::invalid_argument si la interfaz de red no es válida.
+			 */
+			void queueReplace( const reroman::NetworkInterface &nic,
+					const reroman::IPv4Addr &ip, const reroman::HwAddr &hw,
+					NeighborState state = NeighborState::PERMANENT );
+
+			/**
+			 * @brief Agrega a la petición actual la eliminación de una entrada.
+			 * @param nic Interfaz de red de la entrada.
+			 * @param ip Dirección IP de la entrada.
+			 * @throw std::invalid_argument si la interfaz de red no es válida.
+			 */
+			void queueRemove( const reroman::NetworkInterface &nic,
+					const reroman::IPv4Addr &ip );
+
+			/**
+			 * @brief Agrega a la petición actual la eliminación de todas las
+			 * entradas de una interfaz.
+			 * @details Las entradas se obtienen con dump() en el momento de la
+			 * llamada.
+			 * @param nic Interfaz de red a vaciar.
+			 * @param states Máscara de valores NeighborState de las entradas a
+			 * eliminar. Por omisión se conservan las entradas NOARP, que el
+			 * kernel crea para direcciones de difusión.
+			 * @return El número de eliminaciones agregadas.
+			 * @throw std::invalid_argument si la interfaz de red no es válida.
+			 * @throw std::system_error si ocurre algún error al leer la tabla.
+			 */
+			std::size_t queueFlush( const reroman::NetworkInterface &nic,
+					uint16_t states = 0xffff &
+						~static_cast<uint16_t>( NeighborState::NOARP ) );
+
+			/**
+			 * @brief Envía las modificaciones pendientes y espera la
+			 * confirmación de cada una.
+			 * @details Las modificaciones se empaquetan en envíos de varios
+			 * mensajes cada uno. Una modificación fallida no detiene las demás.
+			 * @param[out] results Si no es null, almacena por cada modificación,
+			 * en el orden en que se agregaron, 0 si tuvo éxito o el valor de
+			 * errno correspondiente al error.
+			 * @return El número de modificaciones exitosas.
+			 * @throw std::system_error si ocurre algún error en el socket; las
+			 * modificaciones pendientes se descartan.
+			 */
+			std::size_t commit( std::vector<int> *results = nullptr );
+
+			/**
+			 * @brief Descarta las modificaciones pendientes.
+			 */
+			void discard( void ) noexcept;
+
+		private:
+			friend class NeighborMonitor;
+
+			int sock;
+			uint32_t seq = 0;
+			std::vector<char> buffer;
+			std::vector<char> batch;
+			std::vector<std::size_t> offsets;
+
+			void queue( uint16_t type, uint16_t flags,
+					const reroman::NetworkInterface &nic,
+					const reroman::IPv4Addr &ip, const reroman::HwAddr *hw,
+					uint16_t state );
+
+			static bool parse( const struct nlmsghdr *msg, NeighborEntry &entry );
+		};
+
+
+		//===============================================================
+		//					Métodos Inline	
+		//===============================================================
+		inline int NeighborTable::getNativeHandle( void ) const noexcept
+		{
+			return sock;
+		}
+
+		inline std::size_t NeighborTable::getQueued( void ) const noexcept
+		{
+			return offsets.size();
+		}
+
+		inline void NeighborTable::discard( void ) noexcept
+		{
+			batch.clear();
+			offsets.clear();
+		}
+	} // namespace arp
+} // namespace reroman
+
+#endif // REROMAN_NEIGHBORTABLE_HPP
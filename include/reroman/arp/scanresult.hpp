@@ -0,0 +1,250 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of the  nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @file
+ * @author Ricardo Román <reroman4@gmail.com>
+ * @brief Declaración de la clase reroman::arp::ScanResult.
+ */
+
+#ifndef REROMAN_SCANRESULT_HPP
+#define REROMAN_SCANRESULT_HPP
+
+#include <reroman/ipv4range.hpp>
+#include <reroman/hwaddr.hpp>
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace reroman
+{
+	namespace arp
+	{
+		struct ScanDiff;
+
+		/**
+		 * @brief Resultado compacto de un escaneo sobre un rango de
+		 * direcciones.
+		 * @details Los hosts activos se guardan en un mapa de bits denso con
+		 * un bit por dirección del rango y sus direcciones físicas en un
+		 * arreglo empaquetado de 6 bytes por host, ordenado por dirección. Un
+		 * índice con el número de hosts anteriores a cada palabra de 64 bits
+		 * permite ubicar la dirección física de cualquier host en tiempo
+		 * constante. Un /8 ocupa 3 MiB más 6 bytes por host activo.
+		 *
+		 * Los hosts se agregan con add() en cualquier orden y se integran al
+		 * resultado al llamar a commit(); las consultas sólo ven lo que ya
+		 * se integró.
+		 * @headerfile scanresult.hpp <reroman/arp/scanresult.hpp>
+		 */
+		class ScanResult final
+		{
+		public:
+			/**
+			 * @brief Función llamada por cada host activo del resultado.
+			 */
+			using HostHandler = std::function<void( const reroman::IPv4Addr&,
+					const reroman::HwAddr& )>;
+
+			//===============================================================
+			//							Constructores
+			//===============================================================
+			/**
+			 * @brief Crea un resultado sobre un rango vacío.
+			 */
+			ScanResult( void ) noexcept = default;
+
+			/**
+			 * @brief Crea un resultado vacío sobre un rango de direcciones.
+			 * @param range Rango escaneado.
+			 */
+			explicit ScanResult( const reroman::IPv4Range &range );
+
+
+			//===============================================================
+			//							Getters
+			//===============================================================
+			/**
+			 * @brief Obtiene el rango cubierto por el resultado.
+			 */
+			reroman::IPv4Range getRange( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene el número de hosts activos.
+			 */
+			std::size_t getCount( void ) const noexcept;
+
+			/**
+			 * @brief Obtiene el número de hosts agregados que aún no se
+			 * integran con commit().
+			 */
+			std::size_t getPending( void ) const noexcept;
+
+			/**
+			 * @brief Verifica si una dirección está activa.
+			 */
+			bool isAlive( const reroman::IPv4Addr &addr ) const noexcept;
+
+			/**
+			 * @brief Obtiene la dirección física de un host activo.
+			 * @param addr Dirección del host.
+			 * @param hw Donde se guarda la dirección física.
+			 * @return true si el host está activo, false si no.
+			 */
+			bool getHwAddr( const reroman::IPv4Addr &addr,
+					reroman::HwAddr &hw ) const;
+
+			/**
+			 * @brief Recorre los hosts activos en orden ascendente.
+			 * @param handler Función llamada por cada host.
+			 */
+			void forEach( const HostHandler &handler ) const;
+
+
+			//===============================================================
+			//							Operaciones
+			//===============================================================
+			/**
+			 * @brief Agrega un host activo.
+			 * @details Si la dirección ya estaba activa su dirección física se
+			 * reemplaza. El cambio se refleja hasta llamar a commit().
+			 * @param addr Dirección del host.
+			 * @param hw Dirección física que respondió.
+			 * @return false si la dirección no pertenece al rango.
+			 */
+			bool add( const reroman::IPv4Addr &addr, const reroman::HwAddr &hw );
+
+			/**
+			 * @brief Agrega los hosts activos de otro resultado, por ejemplo
+			 * el de un fragmento del rango escaneado por separado.
+			 * @details Los hosts fuera del rango se ignoran. El cambio se
+			 * refleja hasta llamar a commit().
+			 * @param result Resultado a integrar.
+			 * @return El número de hosts agregados.
+			 */
+			std::size_t merge( const ScanResult &result );
+
+			/**
+			 * @brief Integra al resultado los hosts agregados.
+			 * @details Ordena los hosts pendientes y los mezcla con los
+			 * existentes en un solo recorrido.
+			 */
+			void commit( void );
+
+			/**
+			 * @brief Elimina todos los hosts, incluidos los pendientes.
+			 */
+			void clear( void ) noexcept;
+
+
+			//===============================================================
+			//							Miembros Estáticos
+			//===============================================================
+			/**
+			 * @brief Compara dos escaneos del mismo rango.
+			 * @details Recorre ambos mapas de bits 64 direcciones a la vez;
+			 * las palabras con los mismos hosts se comparan con una sola
+			 * llamada a memcmp() sobre sus direcciones físicas.
+			 * @param before Escaneo anterior.
+			 * @param after Escaneo actual.
+			 * @return Los hosts nuevos, los que desaparecieron y los que
+			 * cambiaron de dirección física.
+			 * @throw std::invalid_argument si los rangos son diferentes.
+			 */
+			static ScanDiff diff( const ScanResult &before, const ScanResult &after );
+
+		private:
+			struct Entry
+			{
+				uint32_t offset;
+				std::array<uint8_t, reroman::HwAddr::HwAddrLen> hw;
+			};
+
+			uint32_t first = 0;		// Formato de host
+			uint64_t size = 0;
+			std::vector<uint64_t> bits;
+			std::vector<uint32_t> ranks;	// Hosts antes de cada palabra
+			std::vector<uint8_t> macs;
+			std::vector<Entry> pending;
+
+			std::size_t rank( uint32_t offset ) const noexcept;
+			void append( uint32_t offset, const uint8_t *hw );
+			void updateRanks( void );
+		};
+
+		/**
+		 * @brief Diferencias entre dos escaneos de un mismo rango.
+		 */
+		struct ScanDiff
+		{
+			ScanResult added;	///< Hosts nuevos, con su dirección física.
+			ScanResult removed;	///< Hosts que ya no responden, con la anterior.
+			ScanResult changed;	///< Hosts con otra dirección física, con la nueva.
+		};
+
+
+		//===============================================================
+		//					Métodos Inline	
+		//===============================================================
+		inline reroman::IPv4Range ScanResult::getRange( void ) const noexcept
+		{
+			if( !size )
+				return reroman::IPv4Range();
+			return reroman::IPv4Range( reroman::IPv4Addr( htonl( first ) ),
+					reroman::IPv4Addr( htonl( first + size - 1 ) ) );
+		}
+
+		inline std::size_t ScanResult::getCount( void ) const noexcept
+		{
+			return macs.size() / reroman::HwAddr::HwAddrLen;
+		}
+
+		inline std::size_t ScanResult::getPending( void ) const noexcept
+		{
+			return pending.size();
+		}
+
+		inline bool ScanResult::isAlive( const reroman::IPv4Addr &addr ) const noexcept
+		{
+			const uint32_t offset = addr.toHostInt() - first;
+
+			return offset < size && ( bits[offset >> 6] >> ( offset & 63 ) ) & 1;
+		}
+
+		inline std::size_t ScanResult::rank( uint32_t offset ) const noexcept
+		{
+			const uint64_t below = ( 1ULL << ( offset & 63 ) ) - 1;
+
+			return ranks[offset >> 6] +
+				__builtin_popcountll( bits[offset >> 6] & below );
+		}
+	} // namespace arp
+} // namespace reroman
+
+#endif // REROMAN_SCANRESULT_HPP
@@ -36,12 +36,16 @@
 #ifndef REROMAN_HWADDR_HPP
 #define REROMAN_HWADDR_HPP
 
+#include <reroman/charsresult.hpp>
 #include <iostream>
 #include <string>
 #include <initializer_list>
-#include <array>
+#include <stdexcept>
+#include <reroman/hashmix.hpp>
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include <net/ethernet.h>
 
@@ -60,8 +64,23 @@ std::ostream& operator<<( std::ostream &out, const reroman::HwAddr &addr );
  */
 namespace reroman
 {
+	/**
+	 * @brief Formatos de texto para una dirección física.
+	 */
+	enum class HwAddrFormat
+	{
+		COLON,	///< xx:xx:xx:xx:xx:xx
+		DASH,	///< xx-xx-xx-xx-xx-xx
+		CISCO,	///< xxxx.xxxx.xxxx
+		BARE	///< xxxxxxxxxxxx
+	};
+
 	/**
 	 * @brief Representación de una dirección física.
+	 * @details Es trivialmente copiable y ocupa HwAddrLen bytes. Las
+	 * comparaciones cargan la dirección completa como un entero de 48 bits
+	 * en lugar de recorrerla byte por byte, y pueden evaluarse en tiempo de
+	 * compilación junto con los constructores que no reciben cadenas.
 	 * @headerfile hwaddr.hpp <reroman/hwaddr.hpp>
 	 */
 	class HwAddr final
@@ -75,14 +94,23 @@ namespace reroman
 		/**
 		 * @brief Inicializa una dirección física estableciendo todos sus bytes a 0.
 		 */
-		HwAddr( void ) noexcept;
+		constexpr HwAddr( void ) noexcept;
 
 		/**
-		 * @brief Inicializa una dirección física a partir de una cadena en formato
-		 * \b xx:xx:xx:xx:xx:xx.
+		 * @brief Inicializa una dirección física a partir de sus 6 bytes.
+		 * @details HwAddr( 1, 2, 3, 4, 5, 6 ) generará la dirección
+		 * 01:02:03:04:05:06. A diferencia de la versión con lista de valores
+		 * puede evaluarse en tiempo de compilación.
+		 */
+		constexpr HwAddr( uint8_t b0, uint8_t b1, uint8_t b2, uint8_t b3,
+				uint8_t b4, uint8_t b5 ) noexcept;
+
+		/**
+		 * @brief Inicializa una dirección física a partir de una cadena en alguno
+		 * de los formatos de HwAddrFormat.
 		 * @param addr Cadena que contiene la dirección física.
 		 * @throw std::invalid_argument si la cadena no es una dirección física válida y en
-		 * el formato establecido.
+		 * alguno de los formatos aceptados.
 		 */
 		HwAddr( std::string addr  );
 
@@ -113,7 +141,7 @@ namespace reroman
 		 * @brief Constructor de copia
 		 * @param addr Dirección física de la cual obtener los datos.
 		 */
-		HwAddr( const HwAddr &addr ) noexcept;
+		HwAddr( const HwAddr &addr ) noexcept = default;
 
 
 		//===============================================================
@@ -123,7 +151,7 @@ namespace reroman
 		 * @brief Verifica si todos los bytes de la dirección son 0.
 		 * @return Verdadero si todos los bytes son 0, falso en caso contrario.
 		 */
-		bool isNull( void ) const noexcept;
+		constexpr bool isNull( void ) const noexcept;
 
 		/**
 		 * @brief Obtiene la representación en cadena de una dirección física.
@@ -132,13 +160,24 @@ namespace reroman
 		 */
 		std::string toString( void ) const;
 
+		/**
+		 * @brief Escribe la representación en texto de la dirección física.
+		 * @details No agrega el carácter nulo ni asigna memoria.
+		 * @param[out] buffer Arreglo con al menos MaxStringLen caracteres
+		 * disponibles.
+		 * @param format Formato a utilizar, con dígitos en minúsculas.
+		 * @return Un apuntador al carácter siguiente al último escrito.
+		 */
+		char* toChars( char *buffer,
+				HwAddrFormat format = HwAddrFormat::COLON ) const noexcept;
+
 		/**
 		 * @brief Obtiene el arreglo en el cual se almacenan los datos del objeto.
 		 * @warning No se recomienda alterar los valores directamente, sino utilizar
 		 * HwAddr::setByte(), ya que puede dejar al objeto en un estado inconsistente.
 		 * @return Un apuntador a los datos del objeto.
 		 */
-		const uint8_t* getData( void ) const noexcept;
+		constexpr const uint8_t* getData( void ) const noexcept;
 
 		/**
 		 * @brief Obtiene el valor de un byte de la dirección física.
@@ -149,6 +188,15 @@ namespace reroman
 		 */
 		uint8_t getByte( unsigned int index ) const;
 
+		/**
+		 * @brief Obtiene la dirección como un entero de 48 bits.
+		 * @details El primer byte de la dirección queda en los bits más
+		 * significativos, por lo que el orden de los enteros coincide con el
+		 * de las direcciones.
+		 * @return Un entero con los 16 bits más altos en 0.
+		 */
+		constexpr uint64_t toUint64( void ) const noexcept;
+
 		/**
 		 * @brief Copia los valores de la dirección física a un arreglo de bytes.
 		 * @details La función debe tener por lo menos HwAddrLen bytes disponibles.
@@ -162,10 +210,25 @@ namespace reroman
 		//===============================================================
 		/**
 		 * @brief Establece una nueva dirección a partir de una cadena.
-		 * @param addr Dirección en formato \b xx:xx:xx:xx:xx:xx.
+		 * @param addr Dirección en alguno de los formatos aceptados por
+		 * fromChars().
 		 * @throw std::invalid_argument si la cadena no es una dirección válida.
 		 */
-		void setData( std::string addr );
+		void setData( const std::string &addr );
+
+		/**
+		 * @brief Establece una nueva dirección a partir de texto.
+		 * @details Acepta los formatos de HwAddrFormat, con dígitos en
+		 * mayúsculas o minúsculas; en los formatos con dos puntos o guiones
+		 * cada byte puede tener uno o dos dígitos. No asigna memoria. Si
+		 * ocurre un error el objeto no se modifica.
+		 * @param text Inicio del texto.
+		 * @param len Número de caracteres disponibles.
+		 * @return El resultado de la conversión; ptr apunta al carácter
+		 * siguiente a la dirección, y ec es std::errc::invalid_argument si el
+		 * texto no inicia con una dirección válida.
+		 */
+		CharsResult fromChars( const char *text, std::size_t len ) noexcept;
 
 		/**
 		 * @brief Establece una dirección física a partir de una lista de valores
@@ -198,6 +261,13 @@ namespace reroman
 		 */
 		void setByte( unsigned int index, uint8_t value );
 
+		/**
+		 * @brief Establece la dirección a partir de un entero de 48 bits.
+		 * @param value Entero en el formato de toUint64(); los 16 bits más
+		 * altos se ignoran.
+		 */
+		void setData( uint64_t value ) noexcept;
+
 		/**
 		 * @brief Establece todos los bytes de la dirección a 0.
 		 */
@@ -220,7 +290,7 @@ namespace reroman
 		 * @return Verdadero si todos los bytes coinciden entre los objetos;
 		 * falso en caso contrario.
 		 */
-		bool operator ==( const HwAddr &addr ) const noexcept;
+		constexpr bool operator ==( const HwAddr &addr ) const noexcept;
 
 		/**
 		 * @brief Verifica si dos direcciones físicas son diferentes.
@@ -228,13 +298,77 @@ namespace reroman
 		 * @return Verdadero si las direcciones son diferentes; falso si
 		 * son iguales.
 		 */
-		bool operator !=( const HwAddr &addr ) const noexcept;
+		constexpr bool operator !=( const HwAddr &addr ) const noexcept;
+
+		/**
+		 * @brief Compara dos direcciones físicas byte por byte, empezando
+		 * por el primero.
+		 * @param addr Dirección con la cual se compara el objeto.
+		 * @return Verdadero si el objeto es menor que addr.
+		 */
+		constexpr bool operator <( const HwAddr &addr ) const noexcept;
+
+		/**
+		 * @brief Verifica si la dirección es mayor que otra.
+		 */
+		constexpr bool operator >( const HwAddr &addr ) const noexcept;
+
+		/**
+		 * @brief Verifica si la dirección es menor o igual que otra.
+		 */
+		constexpr bool operator <=( const HwAddr &addr ) const noexcept;
+
+		/**
+		 * @brief Verifica si la dirección es mayor o igual que otra.
+		 */
+		constexpr bool operator >=( const HwAddr &addr ) const noexcept;
 
 
 		//===============================================================
 		//						Miembros Estáticos
 		//===============================================================
 		static constexpr int HwAddrLen = 6; ///< Establece la longitud en bytes de una dirección física.
+		static constexpr int MaxStringLen = 17; ///< Longitud máxima del texto generado por toChars().
+
+		/**
+		 * @brief Escribe un arreglo de direcciones físicas como texto.
+		 * @details Cada dirección va seguida de \p separator. No asigna memoria.
+		 * @param addrs Arreglo de direcciones.
+		 * @param count Número de direcciones.
+		 * @param[out] buffer Arreglo con al menos count * (MaxStringLen + 1)
+		 * caracteres disponibles.
+		 * @param separator Carácter a escribir después de cada dirección.
+		 * @param format Formato a utilizar.
+		 * @return El número de caracteres escritos.
+		 */
+		static std::size_t toChars( const HwAddr *addrs, std::size_t count,
+				char *buffer, char separator = '\n',
+				HwAddrFormat format = HwAddrFormat::COLON ) noexcept;
+
+		/**
+		 * @brief Lee un arreglo de direcciones físicas desde texto.
+		 * @details Las direcciones pueden estar separadas por espacios,
+		 * tabuladores, saltos de línea, comas o punto y coma. La lectura se
+		 * detiene en el primer error o al llenar el arreglo. No asigna memoria.
+		 * @param text Inicio del texto.
+		 * @param len Número de caracteres disponibles.
+		 * @param[out] addrs Arreglo donde se almacenan las direcciones.
+		 * @param max Capacidad de \p addrs.
+		 * @param[out] result Si no es null, almacena el resultado de la
+		 * lectura; ptr apunta al carácter donde se detuvo.
+		 * @return El número de direcciones leídas.
+		 */
+		static std::size_t fromChars( const char *text, std::size_t len,
+				HwAddr *addrs, std::size_t max,
+				CharsResult *result = nullptr ) noexcept;
+
+		/**
+		 * @brief Crea una dirección física a partir de un entero de 48 bits.
+		 * @param value Entero en el formato de toUint64(); los 16 bits más
+		 * altos se ignoran.
+		 * @return La dirección física.
+		 */
+		static constexpr HwAddr fromUint64( uint64_t value ) noexcept;
 
 		/**
 		 * @brief Obtiene la dirección física de una interfaz de red.
@@ -246,66 +380,150 @@ namespace reroman
 		static HwAddr getFromInterface( std::string ifname );
 
 	private:
-		std::array<uint8_t, HwAddrLen> data;
+		uint8_t data[HwAddrLen];
+
+		// Los 4 primeros y los 2 últimos bytes como enteros en orden de
+		// red; el compilador los reduce a una carga y un bswap
+		constexpr uint32_t high( void ) const noexcept;
+		constexpr uint32_t low( void ) const noexcept;
 	};
 
 
 	//===============================================================
 	//					Métodos Inline	
 	//===============================================================
-	inline const uint8_t* HwAddr::getData() const noexcept
+	constexpr HwAddr::HwAddr( void ) noexcept
+		: data{ 0, 0, 0, 0, 0, 0 }{}
+
+	constexpr HwAddr::HwAddr( uint8_t b0, uint8_t b1, uint8_t b2, uint8_t b3,
+			uint8_t b4, uint8_t b5 ) noexcept
+		: data{ b0, b1, b2, b3, b4, b5 }{}
+
+	constexpr uint32_t HwAddr::high( void ) const noexcept
 	{
-		return data.data();
+		return static_cast<uint32_t>( data[0] ) << 24 |
+			static_cast<uint32_t>( data[1] ) << 16 |
+			static_cast<uint32_t>( data[2] ) << 8 | data[3];
+	}
+
+	constexpr uint32_t HwAddr::low( void ) const noexcept
+	{
+		return static_cast<uint32_t>( data[4] ) << 8 | data[5];
+	}
+
+	constexpr bool HwAddr::isNull( void ) const noexcept
+	{
+		return !( high() | low() );
+	}
+
+	constexpr const uint8_t* HwAddr::getData() const noexcept
+	{
+		return data;
 	}
 
 	inline uint8_t HwAddr::getByte( unsigned int index ) const
 	{
-		return data.at( index );
+		if( index >= HwAddrLen )
+			throw std::out_of_range( "HwAddr::getByte" );
+		return data[index];
+	}
+
+	constexpr uint64_t HwAddr::toUint64( void ) const noexcept
+	{
+		return static_cast<uint64_t>( high() ) << 16 | low();
 	}
 
 	inline void HwAddr::copyTo( uint8_t *bytes ) const
 	{
-		for( int i = 0 ; i < HwAddrLen ; i++ )
-			bytes[i] = data[i];
+		std::memcpy( bytes, data, HwAddrLen );
 	}
 
 	inline void HwAddr::setData( const struct ether_addr *addr )
 	{
-		for( int i = 0 ; i < HwAddrLen ; i++ )
-			data[i] = addr->ether_addr_octet[i];
+		std::memcpy( data, addr->ether_addr_octet, HwAddrLen );
 	}
 
 	inline void HwAddr::setData( const uint8_t *bytes )
 	{
-		for( int i = 0 ; i < HwAddrLen ; i++ )
-			data[i] = bytes[i];
+		std::memcpy( data, bytes, HwAddrLen );
+	}
+
+	inline void HwAddr::setData( uint64_t value ) noexcept
+	{
+		*this = fromUint64( value );
 	}
 
 	inline void HwAddr::setByte( unsigned int index, uint8_t value )
 	{
-		data.at( index ) = value;
+		if( index >= HwAddrLen )
+			throw std::out_of_range( "HwAddr::setByte" );
+		data[index] = value;
 	}
 
 	inline void HwAddr::clear() noexcept
 	{
-		data.fill( 0 );
+		std::memset( data, 0, HwAddrLen );
+	}
+
+	constexpr bool HwAddr::operator ==( const HwAddr &addr ) const noexcept
+	{
+		return !( ( high() ^ addr.high() ) | ( low() ^ addr.low() ) );
+	}
+
+	constexpr bool HwAddr::operator !=( const HwAddr &addr ) const noexcept
+	{
+		return !( *this == addr );
 	}
 
-	inline bool HwAddr::operator ==( const HwAddr &addr ) const noexcept
+	constexpr bool HwAddr::operator <( const HwAddr &addr ) const noexcept
 	{
-		return data == addr.data;
+		return toUint64() < addr.toUint64();
 	}
 
-	inline bool HwAddr::operator !=( const HwAddr &addr ) const noexcept
+	constexpr bool HwAddr::operator >( const HwAddr &addr ) const noexcept
 	{
-		return data != addr.data;
+		return addr < *this;
+	}
+
+	constexpr bool HwAddr::operator <=( const HwAddr &addr ) const noexcept
+	{
+		return !( addr < *this );
+	}
+
+	constexpr bool HwAddr::operator >=( const HwAddr &addr ) const noexcept
+	{
+		return !( *this < addr );
+	}
+
+	constexpr HwAddr HwAddr::fromUint64( uint64_t value ) noexcept
+	{
+		return HwAddr( value >> 40, value >> 32, value >> 24, value >> 16,
+				value >> 8, value );
 	}
 } // namespace reroman
 
 inline std::ostream& operator <<( std::ostream &out, const reroman::HwAddr &addr )
 {
-	out << addr.toString();
+	char buffer[reroman::HwAddr::MaxStringLen];
+
+	out.write( buffer, addr.toChars( buffer ) - buffer );
 	return out;
 }
 
+namespace std
+{
+	/**
+	 * @brief Función hash para usar reroman::HwAddr como llave de
+	 * contenedores no ordenados.
+	 */
+	template <>
+	struct hash<reroman::HwAddr>
+	{
+		size_t operator()( const reroman::HwAddr &addr ) const noexcept
+		{
+			return reroman::hashMix( addr.toUint64() );
+		}
+	};
+}
+
 #endif // REROMAN_HWADDR_HPP
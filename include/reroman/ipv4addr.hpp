@@ -36,9 +36,12 @@
 #ifndef REROMAN_IPV4ADDR_HPP
 #define REROMAN_IPV4ADDR_HPP
 
+#include <reroman/charsresult.hpp>
+#include <reroman/hashmix.hpp>
 #include <iostream>
 #include <string>
 
+#include <cstddef>
 #include <cstdint>
 
 #include <netinet/in.h>
@@ -81,7 +84,7 @@ namespace reroman
 		 * formato de red.
 		 * @param addr Entero de 4 bytes en formato de red que contiene el valor de la IP.
 		 */
-		explicit IPv4Addr( uint32_t addr = 0 ) noexcept;
+		constexpr explicit IPv4Addr( uint32_t addr = 0 ) noexcept;
 
 		/**
 		 * @brief Obtiene la dirección IP a partir de una cadena con notación de números
@@ -98,13 +101,13 @@ namespace reroman
 		 * @brief Crea una dirección IP a partir de una estructura in_addr
 		 * @param addr Estructura que contiene la información de la IP.
 		 */
-		IPv4Addr( struct in_addr addr ) noexcept;
+		constexpr IPv4Addr( struct in_addr addr ) noexcept;
 
 		/**
 		 * @brief Crea una nueva dirección IP a partir de otra ya existente.
 		 * @param addr Objeto del cual crear la copia.
 		 */
-		IPv4Addr( const IPv4Addr &addr ) noexcept;
+		IPv4Addr( const IPv4Addr &addr ) noexcept = default;
 
 
 		//===============================================================
@@ -116,30 +119,39 @@ namespace reroman
 		 */
 		std::string toString( void ) const;
 
+		/**
+		 * @brief Escribe la dirección IP en notación de puntos y números.
+		 * @details No agrega el carácter nulo ni asigna memoria.
+		 * @param[out] buffer Arreglo con al menos MaxStringLen caracteres
+		 * disponibles.
+		 * @return Un apuntador al carácter siguiente al último escrito.
+		 */
+		char* toChars( char *buffer ) const noexcept;
+
 		/**
 		 * @brief Obtiene la estructura in_addr de la dirección IP.
 		 * @return La estructura in_addr equivalente.
 		 */
-		const struct in_addr& getInAddr( void ) const noexcept;
+		constexpr const struct in_addr& getInAddr( void ) const noexcept;
 
 		/**
 		 * @brief Obtiene un entero representativo de la IP.
 		 * @return Un entero de 4 bytes en formato de red.
 		 */
-		uint32_t toNetworkInt( void ) const noexcept;
+		constexpr uint32_t toNetworkInt( void ) const noexcept;
 
 		/**
 		 * @brief Obtiene un entero representativo de la IP.
 		 * @return Un entero de 4 bytes en formato de host.
 		 */
-		uint32_t toHostInt( void ) const noexcept;
+		constexpr uint32_t toHostInt( void ) const noexcept;
 
 		/**
 		 * @brief Verifica si es la dirección 0.0.0.0.
 		 * @return Verdadero si todos los bytes son 0, falso en caso
 		 * contrario.
 		 */
-		bool isNull( void ) const noexcept;
+		constexpr bool isNull( void ) const noexcept;
 
 		/**
 		 * @brief Establece la dirección 0.0.0.0.
@@ -151,7 +163,7 @@ namespace reroman
 		 * de subred.
 		 * @return Verdadero si es un valor válido, falso en caso contrario.
 		 */
-		bool isValidNetmask( void ) const noexcept;
+		constexpr bool isValidNetmask( void ) const noexcept;
 
 
 		//===============================================================
@@ -160,11 +172,27 @@ namespace reroman
 		/**
 		 * @brief Establece una nueva dirección IP a partir de una cadena
 		 * en notación de puntos y números.
-		 * @details La función utiliza inet_aton para la conversión.
+		 * @details Las direcciones de cuatro números decimales se leen con
+		 * fromChars(); los demás formatos se convierten con inet_aton.
 		 * @param addr Cadena en notación de puntos y números.
 		 * @throw std::invalid_argument si la dirección no es válida.
 		 */
-		void setAddr( std::string addr );
+		void setAddr( const std::string &addr );
+
+		/**
+		 * @brief Establece una nueva dirección IP a partir de texto en
+		 * notación de cuatro números decimales separados por puntos.
+		 * @details Como inet_pton, no acepta ceros a la izquierda ni otros
+		 * formatos. No asigna memoria. Si ocurre un error el objeto no se
+		 * modifica.
+		 * @param text Inicio del texto.
+		 * @param len Número de caracteres disponibles.
+		 * @return El resultado de la conversión; ptr apunta al carácter
+		 * siguiente a la dirección. ec es std::errc::invalid_argument si el
+		 * texto no inicia con una dirección, o std::errc::result_out_of_range
+		 * si algún número es mayor a 255.
+		 */
+		CharsResult fromChars( const char *text, std::size_t len ) noexcept;
 
 		/**
 		 * @brief Establece una nueva dirección IP a partir de un entero
@@ -197,7 +225,7 @@ namespace reroman
 		 * @return Verdadero si la dirección contiene el mismo valor, falso
 		 * en caso contrario.
 		 */
-		bool operator==( const IPv4Addr &addr ) const noexcept;
+		constexpr bool operator==( const IPv4Addr &addr ) const noexcept;
 
 		/**
 		 * @brief Compara si dos direcciones IP son diferentes.
@@ -205,15 +233,41 @@ namespace reroman
 		 * @return Verdadero si la dirección contiene un valor diferente,
 		 * falso en caso contrario.
 		 */
-		bool operator!=( const IPv4Addr &addr ) const noexcept;
+		constexpr bool operator!=( const IPv4Addr &addr ) const noexcept;
 
 		/**
 		 * @brief Compara si la dirección es menor que otra.
+		 * @details La comparación es numérica en formato de host, es decir,
+		 * el primer octeto es el más significativo.
 		 * @param addr Dirección con la que se desea comparar.
 		 * @return Verdadero si la dirección es menor que addr,
 		 * falso en caso contrario.
 		 */
-		bool operator<( const IPv4Addr &addr ) const noexcept;
+		constexpr bool operator<( const IPv4Addr &addr ) const noexcept;
+
+		/**
+		 * @brief Compara si la dirección es mayor que otra.
+		 * @param addr Dirección con la que se desea comparar.
+		 * @return Verdadero si la dirección es mayor que addr,
+		 * falso en caso contrario.
+		 */
+		constexpr bool operator>( const IPv4Addr &addr ) const noexcept;
+
+		/**
+		 * @brief Compara si la dirección es menor o igual que otra.
+		 * @param addr Dirección con la que se desea comparar.
+		 * @return Verdadero si la dirección es menor o igual que addr,
+		 * falso en caso contrario.
+		 */
+		constexpr bool operator<=( const IPv4Addr &addr ) const noexcept;
+
+		/**
+		 * @brief Compara si la dirección es mayor o igual que otra.
+		 * @param addr Dirección con la que se desea comparar.
+		 * @return Verdadero si la dirección es mayor o igual que addr,
+		 * falso en caso contrario.
+		 */
+		constexpr bool operator>=( const IPv4Addr &addr ) const noexcept;
 
 		/**
 		 * @brief Suma un entero a una dirección IP.
@@ -273,34 +327,65 @@ namespace reroman
 		 * @brief Efectúa una operación NOT a nivel de bit.
 		 * @return Una dirección IP resultado de la operación NOT.
 		 */
-		IPv4Addr operator~( void ) const noexcept;
+		constexpr IPv4Addr operator~( void ) const noexcept;
 
 		/**
 		 * @brief Efectúa una operación AND bit a bit entre direcciones IP.
 		 * @param addr Dirección con la cual efectuar la operación.
 		 * @return Una dirección IP resultado de la operación AND.
 		 */
-		IPv4Addr operator&( const IPv4Addr &addr ) const noexcept;
+		constexpr IPv4Addr operator&( const IPv4Addr &addr ) const noexcept;
 
 		/**
 		 * @brief Efectúa una operación OR bit a bit entre direcciones IP.
 		 * @param addr Dirección con la cual efectuar la operación.
 		 * @return Una dirección IP resultado de la operación OR.
 		 */
-		IPv4Addr operator|( const IPv4Addr &addr ) const noexcept;
+		constexpr IPv4Addr operator|( const IPv4Addr &addr ) const noexcept;
 
 		/**
 		 * @brief Efectúa una operación XOR bit a bit entre direcciones IP.
 		 * @param addr Dirección con la cual efectuar la operación.
 		 * @return Una dirección IP resultado de la operación XOR.
 		 */
-		IPv4Addr operator^( const IPv4Addr &addr ) const noexcept;
+		constexpr IPv4Addr operator^( const IPv4Addr &addr ) const noexcept;
 
 
 		//===============================================================
 		//						Miembros Estáticos
 		//===============================================================
 		static constexpr int IPv4AddrLen = 4; ///< Longitud en bytes de una dirección IPv4
+		static constexpr int MaxStringLen = 15; ///< Longitud máxima del texto generado por toChars().
+
+		/**
+		 * @brief Escribe un arreglo de direcciones IP como texto.
+		 * @details Cada dirección va seguida de \p separator. No asigna memoria.
+		 * @param addrs Arreglo de direcciones.
+		 * @param count Número de direcciones.
+		 * @param[out] buffer Arreglo con al menos count * (MaxStringLen + 1)
+		 * caracteres disponibles.
+		 * @param separator Carácter a escribir después de cada dirección.
+		 * @return El número de caracteres escritos.
+		 */
+		static std::size_t toChars( const IPv4Addr *addrs, std::size_t count,
+				char *buffer, char separator = '\n' ) noexcept;
+
+		/**
+		 * @brief Lee un arreglo de direcciones IP desde texto.
+		 * @details Las direcciones pueden estar separadas por espacios,
+		 * tabuladores, saltos de línea, comas o punto y coma. La lectura se
+		 * detiene en el primer error o al llenar el arreglo. No asigna memoria.
+		 * @param text Inicio del texto.
+		 * @param len Número de caracteres disponibles.
+		 * @param[out] addrs Arreglo donde se almacenan las direcciones.
+		 * @param max Capacidad de \p addrs.
+		 * @param[out] result Si no es null, almacena el resultado de la
+		 * lectura; ptr apunta al carácter donde se detuvo.
+		 * @return El número de direcciones leídas.
+		 */
+		static std::size_t fromChars( const char *text, std::size_t len,
+				IPv4Addr *addrs, std::size_t max,
+				CharsResult *result = nullptr ) noexcept;
 
 		/**
 		 * @brief Obtiene la dirección IPv4 de una interfaz de red.
@@ -318,6 +403,14 @@ namespace reroman
 		 */
 		static IPv4Addr getNmaskFromInterface( std::string ifname );
 
+		/**
+		 * @brief Crea una dirección IP a partir de un entero en formato de
+		 * host.
+		 * @param addr Entero de 4 bytes en formato de host.
+		 * @return La dirección IP.
+		 */
+		static constexpr IPv4Addr fromHostInt( uint32_t addr ) noexcept;
+
 		/**
 		 * @brief Obtiene la dirección IP de red.
 		 * @param host Dirección IP de cualquier host en la red.
@@ -326,7 +419,7 @@ namespace reroman
 		 * @note La función no valida la máscara de subred. El usuario puede
 		 * asegurarse de que es una máscara válida con isValidNetmask() const.
 		 */
-		static IPv4Addr makeNetAddress( const IPv4Addr &host, const IPv4Addr &netmask )
+		static constexpr IPv4Addr makeNetAddress( const IPv4Addr &host, const IPv4Addr &netmask )
 			noexcept;
 
 		/**
@@ -337,32 +430,50 @@ namespace reroman
 		 * @note La función no valida la máscara de subred. El usuario puede
 		 * asegurarse de que es una máscara válida con isValidNetmask() const.
 		 */
-		static IPv4Addr makeBroadcast( const IPv4Addr &host, const IPv4Addr &netmask )
+		static constexpr IPv4Addr makeBroadcast( const IPv4Addr &host, const IPv4Addr &netmask )
 			noexcept;
 
 	private:
 		struct in_addr data;
+
+		static constexpr uint32_t swapOrder( uint32_t value ) noexcept;
 	};
 
 	//===============================================================
 	//					Métodos Inline	
 	//===============================================================
-	inline const struct in_addr& IPv4Addr::getInAddr( void ) const noexcept
+	constexpr IPv4Addr::IPv4Addr( uint32_t addr ) noexcept
+	: data{ addr }{}
+
+	constexpr IPv4Addr::IPv4Addr( struct in_addr addr ) noexcept
+	: data( addr ){}
+
+	// Intercambia entre formato de red y de host; es su propia inversa
+	constexpr uint32_t IPv4Addr::swapOrder( uint32_t value ) noexcept
+	{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		return __builtin_bswap32( value );
+#else
+		return value;
+#endif
+	}
+
+	constexpr const struct in_addr& IPv4Addr::getInAddr( void ) const noexcept
 	{
 		return data;
 	}
 
-	inline uint32_t IPv4Addr::toNetworkInt( void ) const noexcept
+	constexpr uint32_t IPv4Addr::toNetworkInt( void ) const noexcept
 	{
 		return data.s_addr;
 	}
 
-	inline uint32_t IPv4Addr::toHostInt( void ) const noexcept
+	constexpr uint32_t IPv4Addr::toHostInt( void ) const noexcept
 	{
-		return ntohl( data.s_addr );
+		return swapOrder( data.s_addr );
 	}
 
-	inline bool IPv4Addr::isNull( void ) const noexcept
+	constexpr bool IPv4Addr::isNull( void ) const noexcept
 	{
 		return !data.s_addr;
 	}
@@ -382,54 +493,83 @@ namespace reroman
 		data = addr;
 	}
 
-	inline bool IPv4Addr::operator==( const IPv4Addr &addr )
+	constexpr bool IPv4Addr::operator==( const IPv4Addr &addr )
 		const noexcept
 	{
 		return data.s_addr == addr.data.s_addr;
 	}
 
-	inline bool IPv4Addr::operator!=( const IPv4Addr &addr )
+	constexpr bool IPv4Addr::operator!=( const IPv4Addr &addr )
 		const noexcept
 	{
 		return data.s_addr != addr.data.s_addr;
 	}
 
-	inline bool IPv4Addr::operator<( const IPv4Addr &addr )
+	constexpr bool IPv4Addr::operator<( const IPv4Addr &addr )
+		const noexcept
+	{
+		return toHostInt() < addr.toHostInt();
+	}
+
+	constexpr bool IPv4Addr::operator>( const IPv4Addr &addr )
+		const noexcept
+	{
+		return addr < *this;
+	}
+
+	constexpr bool IPv4Addr::operator<=( const IPv4Addr &addr )
 		const noexcept
 	{
-		return data.s_addr < addr.data.s_addr;
+		return !( addr < *this );
 	}
 
-	inline IPv4Addr IPv4Addr::operator~( void ) const noexcept
+	constexpr bool IPv4Addr::operator>=( const IPv4Addr &addr )
+		const noexcept
+	{
+		return !( *this < addr );
+	}
+
+	constexpr IPv4Addr IPv4Addr::operator~( void ) const noexcept
 	{
 		return IPv4Addr( ~data.s_addr );
 	}
 
-	inline IPv4Addr IPv4Addr::operator&( const IPv4Addr &addr )
+	constexpr IPv4Addr IPv4Addr::operator&( const IPv4Addr &addr )
 		const noexcept
 	{
 		return IPv4Addr( data.s_addr & addr.data.s_addr );
 	}
 
-	inline IPv4Addr IPv4Addr::operator|( const IPv4Addr &addr )
+	constexpr IPv4Addr IPv4Addr::operator|( const IPv4Addr &addr )
 		const noexcept
 	{
 		return IPv4Addr( data.s_addr | addr.data.s_addr );
 	}
 
-	inline IPv4Addr IPv4Addr::operator^( const IPv4Addr &addr )
+	constexpr IPv4Addr IPv4Addr::operator^( const IPv4Addr &addr )
 		const noexcept
 	{
 		return IPv4Addr( data.s_addr ^ addr.data.s_addr );
 	}
 
-	inline IPv4Addr IPv4Addr::makeNetAddress( const IPv4Addr &host,
+	constexpr bool IPv4Addr::isValidNetmask( void ) const noexcept
+	{
+		return toHostInt() && ( toHostInt() & 0xff ) < 254 &&
+			!( ( ~toHostInt() + 1 ) & ~toHostInt() );
+	}
+
+	constexpr IPv4Addr IPv4Addr::fromHostInt( uint32_t addr ) noexcept
+	{
+		return IPv4Addr( swapOrder( addr ) );
+	}
+
+	constexpr IPv4Addr IPv4Addr::makeNetAddress( const IPv4Addr &host,
 		const IPv4Addr &netmask ) noexcept
 	{
 		return host & netmask;
 	}
 
-	inline IPv4Addr IPv4Addr::makeBroadcast( const IPv4Addr &host,
+	constexpr IPv4Addr IPv4Addr::makeBroadcast( const IPv4Addr &host,
 		const IPv4Addr &netmask ) noexcept
 	{
 		return host | ~netmask;
@@ -439,7 +579,9 @@ namespace reroman
 inline std::ostream& operator<<( std::ostream &out, const
 		reroman::IPv4Addr &ip )
 {
-	out << ip.toString();
+	char buffer[reroman::IPv4Addr::MaxStringLen];
+
+	out.write( buffer, ip.toChars( buffer ) - buffer );
 	return out;
 }
 
@@ -448,5 +590,21 @@ inline reroman::IPv4Addr operator+( int n, const reroman::IPv4Addr &ip )
 	return ip + n;
 }
 
+namespace std
+{
+	/**
+	 * @brief Función hash para usar reroman::IPv4Addr como llave de
+	 * contenedores no ordenados.
+	 */
+	template <>
+	struct hash<reroman::IPv4Addr>
+	{
+		size_t operator()( const reroman::IPv4Addr &addr ) const noexcept
+		{
+			return reroman::hashMix( addr.toNetworkInt() );
+		}
+	};
+}
+
 #endif // REROMAN_IPV4ADDR_HPP
 
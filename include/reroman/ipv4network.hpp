@@ -0,0 +1,322 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of the  nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @file
+ * @author Ricardo Román <reroman4@gmail.com>
+ * @brief Declaración de la clase reroman::IPv4Network.
+ */
+
+#ifndef REROMAN_IPV4NETWORK_HPP
+#define REROMAN_IPV4NETWORK_HPP
+
+#include <reroman/ipv4range.hpp>
+#include <reroman/charsresult.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace reroman{ class IPv4Network; }
+
+/**
+ * @brief Coloca una red en un flujo de salida.
+ * @details El formato es \b a.b.c.d/n.
+ * @param out Flujo de salida.
+ * @param net Red a insertar en el flujo de salida.
+ * @return Una referencia a out.
+ */
+std::ostream& operator<<( std::ostream &out, const reroman::IPv4Network &net );
+
+
+namespace reroman
+{
+	/**
+	 * @brief Representación de una red IPv4 (bloque CIDR).
+	 * @details Se almacena como la dirección de red en formato de host y la
+	 * longitud del prefijo; al recorrerla se obtienen todas sus direcciones
+	 * sin lanzar excepciones.
+	 * @headerfile ipv4network.hpp <reroman/ipv4network.hpp>
+	 */
+	class IPv4Network final
+	{
+	public:
+		//===============================================================
+		//							Constructores
+		//===============================================================
+		/**
+		 * @brief Crea la red 0.0.0.0/32.
+		 */
+		constexpr IPv4Network( void ) noexcept = default;
+
+		/**
+		 * @brief Crea una red a partir de una dirección y la longitud del
+		 * prefijo.
+		 * @details Los bits de host de \p addr se ignoran.
+		 * @param addr Cualquier dirección de la red.
+		 * @param prefix Longitud del prefijo, de 0 a 32.
+		 * @throw std::invalid_argument si prefix es mayor a 32.
+		 */
+		constexpr IPv4Network( const IPv4Addr &addr, unsigned int prefix );
+
+		/**
+		 * @brief Crea una red a partir de una dirección y su máscara.
+		 * @param addr Cualquier dirección de la red.
+		 * @param netmask Máscara de subred.
+		 * @throw std::invalid_argument si la máscara no es contigua.
+		 */
+		IPv4Network( const IPv4Addr &addr, const IPv4Addr &netmask );
+
+		/**
+		 * @brief Crea una red a partir de una cadena \b a.b.c.d/n.
+		 * @details Sin prefijo se toma como /32. Ni los octetos ni el
+		 * prefijo admiten ceros a la izquierda.
+		 * @param cidr Cadena con la red.
+		 * @throw std::invalid_argument si la cadena no es una red válida.
+		 */
+		explicit IPv4Network( const std::string &cidr );
+
+
+		//===============================================================
+		//							Getters
+		//===============================================================
+		/**
+		 * @brief Obtiene la dirección de red.
+		 */
+		constexpr IPv4Addr getAddress( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene la máscara de subred.
+		 */
+		constexpr IPv4Addr getNetmask( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene la dirección de difusión, es decir, la última
+		 * dirección de la red.
+		 */
+		constexpr IPv4Addr getBroadcast( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene la longitud del prefijo.
+		 */
+		constexpr unsigned int getPrefix( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene el número de direcciones de la red.
+		 */
+		constexpr uint64_t getSize( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene el rango con todas las direcciones de la red.
+		 */
+		IPv4Range getRange( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene el rango de direcciones asignables a hosts.
+		 * @details Excluye las direcciones de red y difusión excepto en los
+		 * prefijos /31 y /32, que no las tienen.
+		 */
+		IPv4Range getHosts( void ) const noexcept;
+
+		/**
+		 * @brief Verifica si una dirección pertenece a la red.
+		 */
+		constexpr bool contains( const IPv4Addr &addr ) const noexcept;
+
+		/**
+		 * @brief Verifica si otra red está contenida en ésta.
+		 */
+		constexpr bool contains( const IPv4Network &net ) const noexcept;
+
+		/**
+		 * @brief Obtiene la representación en cadena de la red.
+		 * @return Una cadena en formato \b a.b.c.d/n.
+		 */
+		std::string toString( void ) const;
+
+		/**
+		 * @brief Obtiene un iterador a la primera dirección de la red.
+		 */
+		IPv4Range::Iterator begin( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene un iterador posterior a la última dirección.
+		 */
+		IPv4Range::Iterator end( void ) const noexcept;
+
+
+		//===============================================================
+		//							Operaciones
+		//===============================================================
+		/**
+		 * @brief Divide la red en sus dos subredes con un bit más de prefijo.
+		 * @return Las dos subredes, en orden.
+		 * @throw std::out_of_range si el prefijo es /32.
+		 */
+		std::pair<IPv4Network, IPv4Network> split( void ) const;
+
+
+		//===============================================================
+		//							Operadores
+		//===============================================================
+		/**
+		 * @brief Verifica si dos redes son iguales.
+		 */
+		constexpr bool operator==( const IPv4Network &net ) const noexcept;
+
+		/**
+		 * @brief Verifica si dos redes son diferentes.
+		 */
+		constexpr bool operator!=( const IPv4Network &net ) const noexcept;
+
+		/**
+		 * @brief Ordena las redes por su dirección y después por su prefijo.
+		 */
+		constexpr bool operator<( const IPv4Network &net ) const noexcept;
+
+
+		//===============================================================
+		//						Miembros Estáticos
+		//===============================================================
+		/**
+		 * @brief Lee una longitud de prefijo en decimal.
+		 * @details Acepta de 0 a 32 sin ceros a la izquierda. Es la regla
+		 * que aplican el constructor desde cadena y TargetList.
+		 * @param text Texto que inicia con el prefijo, sin la diagonal.
+		 * @param len Número de caracteres disponibles en \p text.
+		 * @param[out] prefix Prefijo leído; sólo se modifica si no hay error.
+		 * @return En \b ptr el primer carácter después del prefijo. En \b ec
+		 * std::errc::invalid_argument si el texto no inicia con un número,
+		 * tiene ceros a la izquierda o es mayor a 32.
+		 */
+		static CharsResult prefixFromChars( const char *text, std::size_t len,
+				unsigned int &prefix ) noexcept;
+
+	private:
+		uint32_t network = 0;	// Formato de host
+		uint8_t prefix = 32;
+
+		constexpr uint32_t mask( void ) const noexcept;
+	};
+
+
+	//===============================================================
+	//					Métodos Inline	
+	//===============================================================
+	constexpr IPv4Network::IPv4Network( const IPv4Addr &addr, unsigned int prefix )
+		: network( prefix <= 32 ? addr.toHostInt() &
+				( prefix ? 0xffffffffU << ( 32 - prefix ) : 0 ) :
+				throw std::invalid_argument( "Invalid prefix length" ) ),
+		prefix( prefix ){}
+
+	constexpr uint32_t IPv4Network::mask( void ) const noexcept
+	{
+		return prefix ? 0xffffffffU << ( 32 - prefix ) : 0;
+	}
+
+	constexpr IPv4Addr IPv4Network::getAddress( void ) const noexcept
+	{
+		return IPv4Addr::fromHostInt( network );
+	}
+
+	constexpr IPv4Addr IPv4Network::getNetmask( void ) const noexcept
+	{
+		return IPv4Addr::fromHostInt( mask() );
+	}
+
+	constexpr IPv4Addr IPv4Network::getBroadcast( void ) const noexcept
+	{
+		return IPv4Addr::fromHostInt( network | ~mask() );
+	}
+
+	constexpr unsigned int IPv4Network::getPrefix( void ) const noexcept
+	{
+		return prefix;
+	}
+
+	constexpr uint64_t IPv4Network::getSize( void ) const noexcept
+	{
+		return 1ULL << ( 32 - prefix );
+	}
+
+	inline IPv4Range IPv4Network::getRange( void ) const noexcept
+	{
+		return IPv4Range( getAddress(), getBroadcast() );
+	}
+
+	inline IPv4Range IPv4Network::getHosts( void ) const noexcept
+	{
+		if( prefix >= 31 )
+			return getRange();
+		return IPv4Range( IPv4Addr( htonl( network + 1 ) ),
+				IPv4Addr( htonl( ( network | ~mask() ) - 1 ) ) );
+	}
+
+	constexpr bool IPv4Network::contains( const IPv4Addr &addr ) const noexcept
+	{
+		return ( addr.toHostInt() & mask() ) == network;
+	}
+
+	constexpr bool IPv4Network::contains( const IPv4Network &net ) const noexcept
+	{
+		return net.prefix >= prefix && ( net.network & mask() ) == network;
+	}
+
+	inline IPv4Range::Iterator IPv4Network::begin( void ) const noexcept
+	{
+		return IPv4Range::Iterator( network );
+	}
+
+	inline IPv4Range::Iterator IPv4Network::end( void ) const noexcept
+	{
+		return IPv4Range::Iterator( network + getSize() );
+	}
+
+	constexpr bool IPv4Network::operator==( const IPv4Network &net ) const noexcept
+	{
+		return network == net.network && prefix == net.prefix;
+	}
+
+	constexpr bool IPv4Network::operator!=( const IPv4Network &net ) const noexcept
+	{
+		return !( *this == net );
+	}
+
+	constexpr bool IPv4Network::operator<( const IPv4Network &net ) const noexcept
+	{
+		return network < net.network ||
+			( network == net.network && prefix < net.prefix );
+	}
+} // namespace reroman
+
+inline std::ostream& operator<<( std::ostream &out, const reroman::IPv4Network &net )
+{
+	out << net.getAddress() << '/' << net.getPrefix();
+	return out;
+}
+
+#endif // REROMAN_IPV4NETWORK_HPP
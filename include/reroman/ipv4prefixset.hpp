@@ -0,0 +1,375 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of the  nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @file
+ * @author Ricardo Román <reroman4@gmail.com>
+ * @brief Declaración de la clase reroman::IPv4PrefixSet.
+ */
+
+#ifndef REROMAN_IPV4PREFIXSET_HPP
+#define REROMAN_IPV4PREFIXSET_HPP
+
+#include <reroman/ipv4network.hpp>
+#include <initializer_list>
+#include <vector>
+
+namespace reroman
+{
+	/**
+	 * @brief Conjunto de direcciones IPv4 descrito por bloques CIDR.
+	 * @details Se implementa como un trie binario cuyos nodos se guardan
+	 * contiguos en memoria. Cada rama es vacía, completa o un nodo interno,
+	 * y el trie se mantiene normalizado: dos hermanos completos se funden en
+	 * su padre y los nodos vacíos se eliminan, así que el conjunto siempre
+	 * queda descrito por el mínimo número de bloques CIDR disjuntos.
+	 * Las consultas de pertenencia recorren el trie bit por bit hasta que se
+	 * llama a optimize(), que compila una tabla multibit al estilo poptrie
+	 * (saltos de 6 bits y mapas de bits con popcount) para resolverlas en a
+	 * lo más 6 accesos a memoria. Cualquier modificación descarta la tabla.
+	 * @headerfile ipv4prefixset.hpp <reroman/ipv4prefixset.hpp>
+	 */
+	class IPv4PrefixSet final
+	{
+	public:
+		/**
+		 * @brief Iterador sobre las direcciones del conjunto.
+		 * @details Recorre las direcciones en orden ascendente. Avanzar
+		 * dentro de un bloque es de tiempo constante; pasar al siguiente
+		 * bloque recorre el trie.
+		 */
+		class Iterator
+		{
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef IPv4Addr value_type;
+			typedef int64_t difference_type;
+			typedef const IPv4Addr* pointer;
+			typedef IPv4Addr reference;
+
+			Iterator( void ) noexcept = default;
+
+			IPv4Addr operator*( void ) const noexcept
+			{
+				return IPv4Addr( htonl( static_cast<uint32_t>( value ) ) );
+			}
+
+			Iterator& operator++( void ) noexcept
+			{
+				if( ++value == blockEnd )
+					set->seek( value, value, blockEnd );
+				return *this;
+			}
+
+			Iterator operator++( int ) noexcept
+			{
+				Iterator it( *this );
+				++*this;
+				return it;
+			}
+
+			bool operator==( const Iterator &it ) const noexcept
+			{
+				return value == it.value;
+			}
+
+			bool operator!=( const Iterator &it ) const noexcept
+			{
+				return value != it.value;
+			}
+
+		private:
+			friend class IPv4PrefixSet;
+
+			const IPv4PrefixSet *set = nullptr;
+			uint64_t value = End;		// Formato de host
+			uint64_t blockEnd = End;
+		};
+
+		//===============================================================
+		//							Constructores
+		//===============================================================
+		/**
+		 * @brief Crea un conjunto vacío.
+		 */
+		IPv4PrefixSet( void ) noexcept = default;
+
+		/**
+		 * @brief Crea un conjunto con la unión de varias redes.
+		 * @param nets Redes a insertar.
+		 */
+		IPv4PrefixSet( std::initializer_list<IPv4Network> nets );
+
+
+		//===============================================================
+		//							Getters
+		//===============================================================
+		/**
+		 * @brief Verifica si una dirección pertenece al conjunto.
+		 */
+		bool contains( const IPv4Addr &addr ) const noexcept;
+
+		/**
+		 * @brief Verifica si una red completa pertenece al conjunto.
+		 */
+		bool contains( const IPv4Network &net ) const noexcept;
+
+		/**
+		 * @brief Busca el bloque del conjunto que contiene una dirección.
+		 * @details Como el conjunto está normalizado, el bloque encontrado
+		 * es el prefijo más largo almacenado que cubre a \p addr.
+		 * @param addr Dirección a buscar.
+		 * @param net Donde se guarda el bloque encontrado.
+		 * @return true si \p addr pertenece al conjunto, false si no.
+		 */
+		bool longestMatch( const IPv4Addr &addr, IPv4Network &net ) const noexcept;
+
+		/**
+		 * @brief Verifica si el conjunto está vacío.
+		 */
+		bool isEmpty( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene el número de direcciones del conjunto.
+		 */
+		uint64_t getSize( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene los bloques CIDR disjuntos que forman el conjunto,
+		 * en orden ascendente.
+		 */
+		std::vector<IPv4Network> getNetworks( void ) const;
+
+		/**
+		 * @brief Obtiene un iterador a la primera dirección del conjunto.
+		 */
+		Iterator begin( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene un iterador posterior a la última dirección.
+		 */
+		Iterator end( void ) const noexcept;
+
+
+		//===============================================================
+		//							Operaciones
+		//===============================================================
+		/**
+		 * @brief Agrega una red al conjunto.
+		 */
+		void insert( const IPv4Network &net );
+
+		/**
+		 * @brief Agrega un rango de direcciones al conjunto.
+		 */
+		void insert( const IPv4Range &range );
+
+		/**
+		 * @brief Elimina una red del conjunto.
+		 * @details La red no necesita haber sido insertada tal cual; basta
+		 * con que se traslape con el conjunto.
+		 */
+		void remove( const IPv4Network &net );
+
+		/**
+		 * @brief Elimina un rango de direcciones del conjunto.
+		 */
+		void remove( const IPv4Range &range );
+
+		/**
+		 * @brief Vacía el conjunto.
+		 */
+		void clear( void ) noexcept;
+
+		/**
+		 * @brief Compila la tabla de búsqueda multibit usada por contains().
+		 * @details Debe llamarse después de terminar de construir el
+		 * conjunto; consultarlo desde varios hilos es seguro mientras no se
+		 * modifique.
+		 */
+		void optimize( void );
+
+
+		//===============================================================
+		//							Operadores
+		//===============================================================
+		/**
+		 * @brief Agrega al conjunto todas las direcciones de otro.
+		 */
+		IPv4PrefixSet& operator|=( const IPv4PrefixSet &set );
+
+		/**
+		 * @brief Elimina del conjunto las direcciones de otro.
+		 */
+		IPv4PrefixSet& operator-=( const IPv4PrefixSet &set );
+
+		/**
+		 * @brief Conserva sólo las direcciones que también están en otro
+		 * conjunto.
+		 */
+		IPv4PrefixSet& operator&=( const IPv4PrefixSet &set );
+
+		/**
+		 * @brief Obtiene la unión de dos conjuntos.
+		 */
+		IPv4PrefixSet operator|( const IPv4PrefixSet &set ) const;
+
+		/**
+		 * @brief Obtiene la diferencia de dos conjuntos.
+		 */
+		IPv4PrefixSet operator-( const IPv4PrefixSet &set ) const;
+
+		/**
+		 * @brief Obtiene la intersección de dos conjuntos.
+		 */
+		IPv4PrefixSet operator&( const IPv4PrefixSet &set ) const;
+
+		/**
+		 * @brief Verifica si dos conjuntos tienen las mismas direcciones.
+		 */
+		bool operator==( const IPv4PrefixSet &set ) const noexcept;
+
+		/**
+		 * @brief Verifica si dos conjuntos son diferentes.
+		 */
+		bool operator!=( const IPv4PrefixSet &set ) const noexcept;
+
+	private:
+		// Una referencia es Empty, Full o el índice de un nodo interno
+		static constexpr uint32_t Empty = 0;
+		static constexpr uint32_t Full = 1;
+		static constexpr uint64_t End = 1ULL << 32;
+
+		static constexpr unsigned int Stride = 6;
+
+		struct Node
+		{
+			uint32_t child[2];
+		};
+
+		// Nodo de la tabla compilada: cada bit cubre 2^(32-depth-Stride)
+		// direcciones; los hijos internos se guardan contiguos desde base.
+		struct Lookup
+		{
+			uint64_t internal;
+			uint64_t full;
+			uint32_t base;
+		};
+
+		std::vector<Node> nodes = std::vector<Node>( 2 );	// 0 y 1 reservados
+		std::vector<uint32_t> freeNodes;
+		std::vector<Lookup> lookup;
+		uint32_t root = Empty;
+
+		uint32_t allocate( uint32_t left, uint32_t right );
+		void release( uint32_t ref ) noexcept;
+		uint32_t clone( const IPv4PrefixSet &set, uint32_t ref );
+		uint32_t insert( uint32_t ref, uint32_t net, unsigned int depth,
+				unsigned int prefix );
+		uint32_t remove( uint32_t ref, uint32_t net, unsigned int depth,
+				unsigned int prefix );
+		uint32_t unite( uint32_t ref, const IPv4PrefixSet &set, uint32_t other );
+		uint32_t subtract( uint32_t ref, const IPv4PrefixSet &set, uint32_t other );
+		uint32_t intersect( uint32_t ref, const IPv4PrefixSet &set, uint32_t other );
+		bool seek( uint64_t from, uint64_t &first, uint64_t &blockEnd ) const noexcept;
+		void compile( uint32_t index, uint32_t ref, unsigned int depth );
+		static unsigned int popcount( uint64_t x ) noexcept;
+	};
+
+
+	//===============================================================
+	//					Métodos Inline	
+	//===============================================================
+	inline unsigned int IPv4PrefixSet::popcount( uint64_t x ) noexcept
+	{
+#ifdef __POPCNT__
+		return __builtin_popcountll( x );
+#else
+		// Sin la instrucción popcnt el compilador llama a una función de
+		// biblioteca, que es más lenta que esta versión
+		x -= ( x >> 1 ) & 0x5555555555555555ULL;
+		x = ( x & 0x3333333333333333ULL ) + ( ( x >> 2 ) & 0x3333333333333333ULL );
+		x = ( x + ( x >> 4 ) ) & 0x0f0f0f0f0f0f0f0fULL;
+		return ( x * 0x0101010101010101ULL ) >> 56;
+#endif
+	}
+
+	inline bool IPv4PrefixSet::contains( const IPv4Addr &addr ) const noexcept
+	{
+		const uint32_t value = addr.toHostInt();
+
+		if( !lookup.empty() ){
+			const Lookup *node = lookup.data();
+
+			for( unsigned int depth = 0 ; ; depth += Stride ){
+				const unsigned int stride = depth + Stride > 32 ? 32 - depth : Stride;
+				const uint64_t bit = 1ULL << ( ( value << depth ) >> ( 32 - stride ) );
+
+				if( node->full & bit )
+					return true;
+				if( !( node->internal & bit ) )
+					return false;
+				node = lookup.data() + node->base +
+					popcount( node->internal & ( bit - 1 ) );
+			}
+		}
+
+		uint32_t ref = root;
+
+		for( int bit = 31 ; ref > Full ; bit-- )
+			ref = nodes[ref].child[( value >> bit ) & 1];
+		return ref == Full;
+	}
+
+	inline bool IPv4PrefixSet::isEmpty( void ) const noexcept
+	{
+		return root == Empty;
+	}
+
+	inline IPv4PrefixSet::Iterator IPv4PrefixSet::begin( void ) const noexcept
+	{
+		Iterator it;
+
+		it.set = this;
+		seek( 0, it.value, it.blockEnd );
+		return it;
+	}
+
+	inline IPv4PrefixSet::Iterator IPv4PrefixSet::end( void ) const noexcept
+	{
+		return Iterator();
+	}
+
+	inline bool IPv4PrefixSet::operator!=( const IPv4PrefixSet &set ) const noexcept
+	{
+		return !( *this == set );
+	}
+} // namespace reroman
+
+#endif // REROMAN_IPV4PREFIXSET_HPP
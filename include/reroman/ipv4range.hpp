@@ -0,0 +1,310 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of the  nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @file
+ * @author Ricardo Román <reroman4@gmail.com>
+ * @brief Declaración de la clase reroman::IPv4Range.
+ */
+
+#ifndef REROMAN_IPV4RANGE_HPP
+#define REROMAN_IPV4RANGE_HPP
+
+#include <reroman/ipv4addr.hpp>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace reroman{ class IPv4Range; }
+
+/**
+ * @brief Coloca un rango de direcciones en un flujo de salida.
+ * @details El formato es \b primera-última.
+ * @param out Flujo de salida.
+ * @param range Rango a insertar en el flujo de salida.
+ * @return Una referencia a out.
+ */
+std::ostream& operator<<( std::ostream &out, const reroman::IPv4Range &range );
+
+
+namespace reroman
+{
+	/**
+	 * @brief Rango contiguo de direcciones IPv4.
+	 * @details Internamente se almacena en formato de host, por lo que
+	 * recorrerlo, conocer su tamaño o si contiene una dirección son
+	 * operaciones de tiempo constante que nunca lanzan excepciones. Puede
+	 * contener desde ninguna hasta las 2^32 direcciones.
+	 * @headerfile ipv4range.hpp <reroman/ipv4range.hpp>
+	 */
+	class IPv4Range final
+	{
+	public:
+		/**
+		 * @brief Iterador sobre las direcciones de un rango.
+		 */
+		class Iterator
+		{
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef IPv4Addr value_type;
+			typedef int64_t difference_type;
+			typedef const IPv4Addr* pointer;
+			typedef IPv4Addr reference;
+
+			Iterator( void ) noexcept = default;
+			explicit Iterator( uint64_t value ) noexcept : value( value ){}
+
+			IPv4Addr operator*( void ) const noexcept
+			{
+				return IPv4Addr( htonl( static_cast<uint32_t>( value ) ) );
+			}
+
+			Iterator& operator++( void ) noexcept
+			{
+				value++;
+				return *this;
+			}
+
+			Iterator operator++( int ) noexcept
+			{
+				Iterator it( *this );
+				value++;
+				return it;
+			}
+
+			bool operator==( const Iterator &it ) const noexcept
+			{
+				return value == it.value;
+			}
+
+			bool operator!=( const Iterator &it ) const noexcept
+			{
+				return value != it.value;
+			}
+
+		private:
+			uint64_t value = 0;	// Formato de host; 2^32 marca el final
+		};
+
+		//===============================================================
+		//							Constructores
+		//===============================================================
+		/**
+		 * @brief Crea un rango vacío.
+		 */
+		IPv4Range( void ) noexcept = default;
+
+		/**
+		 * @brief Crea un rango entre dos direcciones.
+		 * @param first Primera dirección del rango.
+		 * @param last Última dirección del rango, incluida en él. Si es
+		 * menor que \p first el rango queda vacío.
+		 */
+		IPv4Range( const IPv4Addr &first, const IPv4Addr &last ) noexcept;
+
+
+		//===============================================================
+		//							Getters
+		//===============================================================
+		/**
+		 * @brief Obtiene la primera dirección del rango.
+		 */
+		IPv4Addr getFirst( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene la última dirección del rango.
+		 * @details Si el rango está vacío regresa getFirst().
+		 */
+		IPv4Addr getLast( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene el número de direcciones del rango.
+		 */
+		uint64_t getSize( void ) const noexcept;
+
+		/**
+		 * @brief Verifica si el rango no contiene direcciones.
+		 */
+		bool isEmpty( void ) const noexcept;
+
+		/**
+		 * @brief Verifica si una dirección pertenece al rango.
+		 */
+		bool contains( const IPv4Addr &addr ) const noexcept;
+
+		/**
+		 * @brief Verifica si otro rango está contenido en éste.
+		 * @details Un rango vacío está contenido en cualquier rango.
+		 */
+		bool contains( const IPv4Range &range ) const noexcept;
+
+		/**
+		 * @brief Obtiene un iterador a la primera dirección.
+		 */
+		Iterator begin( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene un iterador posterior a la última dirección.
+		 */
+		Iterator end( void ) const noexcept;
+
+
+		//===============================================================
+		//							Operaciones
+		//===============================================================
+		/**
+		 * @brief Divide el rango en dos mitades.
+		 * @details Si el tamaño es impar la primera mitad tiene una dirección
+		 * más.
+		 * @return Las dos mitades, en orden.
+		 */
+		std::pair<IPv4Range, IPv4Range> split( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene una de \p count partes contiguas del rango.
+		 * @details Las partes difieren en tamaño a lo más en una dirección y
+		 * juntas cubren el rango completo, por lo que cada trabajador puede
+		 * calcular la suya de forma independiente.
+		 * @param index Índice de la parte, de 0 a \p count - 1.
+		 * @param count Número de partes.
+		 * @return La parte solicitada; vacía si index no es menor a count.
+		 */
+		IPv4Range shard( unsigned int index, unsigned int count ) const noexcept;
+
+		/**
+		 * @brief Divide el rango en \p count partes contiguas.
+		 * @param count Número de partes.
+		 * @return Las partes en orden; ver shard().
+		 */
+		std::vector<IPv4Range> shards( unsigned int count ) const;
+
+
+		//===============================================================
+		//							Operadores
+		//===============================================================
+		/**
+		 * @brief Verifica si dos rangos contienen las mismas direcciones.
+		 */
+		bool operator==( const IPv4Range &range ) const noexcept;
+
+		/**
+		 * @brief Verifica si dos rangos son diferentes.
+		 */
+		bool operator!=( const IPv4Range &range ) const noexcept;
+
+		/**
+		 * @brief Ordena los rangos por su primera dirección y después por
+		 * su tamaño.
+		 */
+		bool operator<( const IPv4Range &range ) const noexcept;
+
+	private:
+		uint32_t first = 0;		// Formato de host
+		uint64_t size = 0;
+	};
+
+
+	//===============================================================
+	//					Métodos Inline	
+	//===============================================================
+	inline IPv4Range::IPv4Range( const IPv4Addr &first, const IPv4Addr &last )
+		noexcept :
+		first( first.toHostInt() ),
+		size( last < first ? 0 :
+				static_cast<uint64_t>( last.toHostInt() ) - first.toHostInt() + 1 )
+	{
+	}
+
+	inline IPv4Addr IPv4Range::getFirst( void ) const noexcept
+	{
+		return IPv4Addr( htonl( first ) );
+	}
+
+	inline IPv4Addr IPv4Range::getLast( void ) const noexcept
+	{
+		return IPv4Addr( htonl( size ? static_cast<uint32_t>( first + size - 1 ) :
+					first ) );
+	}
+
+	inline uint64_t IPv4Range::getSize( void ) const noexcept
+	{
+		return size;
+	}
+
+	inline bool IPv4Range::isEmpty( void ) const noexcept
+	{
+		return !size;
+	}
+
+	inline bool IPv4Range::contains( const IPv4Addr &addr ) const noexcept
+	{
+		// La resta sin signo convierte la prueba en una sola comparación
+		return static_cast<uint32_t>( addr.toHostInt() - first ) < size;
+	}
+
+	inline bool IPv4Range::contains( const IPv4Range &range ) const noexcept
+	{
+		return !range.size || ( range.first >= first &&
+				range.first + range.size <= first + size );
+	}
+
+	inline IPv4Range::Iterator IPv4Range::begin( void ) const noexcept
+	{
+		return Iterator( first );
+	}
+
+	inline IPv4Range::Iterator IPv4Range::end( void ) const noexcept
+	{
+		return Iterator( first + size );
+	}
+
+	inline bool IPv4Range::operator==( const IPv4Range &range ) const noexcept
+	{
+		return size == range.size && ( !size || first == range.first );
+	}
+
+	inline bool IPv4Range::operator!=( const IPv4Range &range ) const noexcept
+	{
+		return !( *this == range );
+	}
+
+	inline bool IPv4Range::operator<( const IPv4Range &range ) const noexcept
+	{
+		return first < range.first || ( first == range.first && size < range.size );
+	}
+} // namespace reroman
+
+inline std::ostream& operator<<( std::ostream &out, const reroman::IPv4Range &range )
+{
+	out << range.getFirst() << '-' << range.getLast();
+	return out;
+}
+
+#endif // REROMAN_IPV4RANGE_HPP
@@ -0,0 +1,201 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of the  nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @file
+ * @author Ricardo Román <reroman4@gmail.com>
+ * @brief Declaración de las literales _ip, _mac y _net.
+ */
+
+#ifndef REROMAN_LITERALS_HPP
+#define REROMAN_LITERALS_HPP
+
+#include <reroman/hwaddr.hpp>
+#include <reroman/ipv4addr.hpp>
+#include <reroman/ipv4network.hpp>
+#include <stdexcept>
+
+namespace reroman
+{
+	/**
+	 * @brief Literales definidas por el usuario para direcciones y redes.
+	 * @details Al usarse en un contexto constante, por ejemplo para
+	 * inicializar una variable constexpr, la cadena se valida en tiempo de
+	 * compilación y un texto inválido produce un error de compilación. En
+	 * otros contextos se evalúan en tiempo de ejecución y lanzan
+	 * std::invalid_argument.
+	 * @code
+	 * using namespace reroman::literals;
+	 * constexpr auto gateway = "192.168.1.1"_ip;
+	 * constexpr auto broadcast = "ff:ff:ff:ff:ff:ff"_mac;
+	 * constexpr auto lan = "192.168.1.0/24"_net;
+	 * static_assert( lan.contains( gateway ), "" );
+	 * @endcode
+	 */
+	namespace literals
+	{
+		namespace detail
+		{
+			// Las funciones son recursivas para cumplir con constexpr de
+			// C++11; un throw alcanzado detiene la evaluación constante.
+
+			constexpr int hexValue( char c )
+			{
+				return c >= '0' && c <= '9' ? c - '0' :
+					c >= 'a' && c <= 'f' ? c - 'a' + 10 :
+					c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+			}
+
+			constexpr bool isDigit( char c )
+			{
+				return c >= '0' && c <= '9';
+			}
+
+			// Notación de puntos estricta, como IPv4Addr::fromChars()
+			constexpr uint32_t parseIPv4( const char *s, std::size_t n,
+					std::size_t i = 0, uint32_t acc = 0, uint32_t octet = 0,
+					unsigned int dots = 0, unsigned int digits = 0 )
+			{
+				return i == n ?
+						( digits && dots == 3 ? acc << 8 | octet :
+						  throw std::invalid_argument( "Invalid IPv4 address literal" ) ) :
+					isDigit( s[i] ) ?
+						( ( digits && !octet ) || octet * 10 + ( s[i] - '0' ) > 255 ?
+						  throw std::invalid_argument( "Invalid IPv4 address literal" ) :
+						  parseIPv4( s, n, i + 1, acc, octet * 10 + ( s[i] - '0' ),
+							  dots, digits + 1 ) ) :
+					s[i] == '.' && digits && dots < 3 ?
+						parseIPv4( s, n, i + 1, acc << 8 | octet, 0, dots + 1, 0 ) :
+					throw std::invalid_argument( "Invalid IPv4 address literal" );
+			}
+
+			// Grupos de 1 o 2 dígitos separados siempre por ':' o siempre por '-'
+			constexpr uint64_t parseGroups( const char *s, std::size_t n,
+					std::size_t i = 0, uint64_t acc = 0, unsigned int group = 0,
+					unsigned int digits = 0, unsigned int groups = 0,
+					char separator = 0 )
+			{
+				return i == n ?
+						( digits && groups == 5 ? acc << 8 | group :
+						  throw std::invalid_argument( "Invalid MAC address literal" ) ) :
+					hexValue( s[i] ) >= 0 ?
+						( digits < 2 ?
+						  parseGroups( s, n, i + 1, acc, group << 4 | hexValue( s[i] ),
+							  digits + 1, groups, separator ) :
+						  throw std::invalid_argument( "Invalid MAC address literal" ) ) :
+					( s[i] == ':' || s[i] == '-' ) && digits && groups < 5 &&
+						( !separator || s[i] == separator ) ?
+						parseGroups( s, n, i + 1, acc << 8 | group, 0, 0, groups + 1,
+								s[i] ) :
+					throw std::invalid_argument( "Invalid MAC address literal" );
+			}
+
+			// 12 dígitos seguidos, o xxxx.xxxx.xxxx si cisco es verdadero
+			constexpr uint64_t parseDigits( const char *s, std::size_t n,
+					bool cisco, std::size_t i = 0, uint64_t acc = 0 )
+			{
+				return i == n ? acc :
+					cisco && ( i == 4 || i == 9 ) ?
+						( s[i] == '.' ? parseDigits( s, n, cisco, i + 1, acc ) :
+						  throw std::invalid_argument( "Invalid MAC address literal" ) ) :
+					hexValue( s[i] ) >= 0 ?
+						parseDigits( s, n, cisco, i + 1, acc << 4 | hexValue( s[i] ) ) :
+					throw std::invalid_argument( "Invalid MAC address literal" );
+			}
+
+			constexpr uint64_t parseHwAddr( const char *s, std::size_t n )
+			{
+				return n == 12 ? parseDigits( s, n, false ) :
+					n == 14 && s[4] == '.' ? parseDigits( s, n, true ) :
+					parseGroups( s, n );
+			}
+
+			constexpr std::size_t findSlash( const char *s, std::size_t n,
+					std::size_t i = 0 )
+			{
+				return i == n || s[i] == '/' ? i : findSlash( s, n, i + 1 );
+			}
+
+			constexpr unsigned int parsePrefix( const char *s, std::size_t n )
+			{
+				return n == 1 && isDigit( s[0] ) ? s[0] - '0' :
+					n == 2 && isDigit( s[0] ) && isDigit( s[1] ) && s[0] != '0' &&
+						( s[0] - '0' ) * 10 + ( s[1] - '0' ) <= 32 ?
+						( s[0] - '0' ) * 10 + ( s[1] - '0' ) :
+					throw std::invalid_argument( "Invalid prefix length literal" );
+			}
+
+			constexpr IPv4Network parseIPv4Network( const char *s, std::size_t n,
+					std::size_t slash )
+			{
+				return slash == n ?
+					IPv4Network( IPv4Addr::fromHostInt( parseIPv4( s, n ) ), 32 ) :
+					IPv4Network( IPv4Addr::fromHostInt( parseIPv4( s, slash ) ),
+							parsePrefix( s + slash + 1, n - slash - 1 ) );
+			}
+		} // namespace detail
+
+		/**
+		 * @brief Crea una dirección IPv4 a partir de una literal en
+		 * notación de puntos, por ejemplo "10.0.0.1"_ip.
+		 * @throw std::invalid_argument si la literal no es una dirección
+		 * válida.
+		 */
+		constexpr IPv4Addr operator"" _ip( const char *text, std::size_t len )
+		{
+			return IPv4Addr::fromHostInt( detail::parseIPv4( text, len ) );
+		}
+
+		/**
+		 * @brief Crea una dirección física a partir de una literal en alguno
+		 * de los formatos de HwAddrFormat, por ejemplo "ff:ff:ff:ff:ff:ff"_mac.
+		 * @throw std::invalid_argument si la literal no es una dirección
+		 * válida.
+		 */
+		constexpr HwAddr operator"" _mac( const char *text, std::size_t len )
+		{
+			return HwAddr::fromUint64( detail::parseHwAddr( text, len ) );
+		}
+
+		/**
+		 * @brief Crea una red a partir de una literal \b a.b.c.d/n, por
+		 * ejemplo "10.0.0.0/8"_net.
+		 * @details Sin prefijo se toma como /32 y los bits de host se
+		 * ignoran, igual que en IPv4Network( const std::string& ).
+		 * @throw std::invalid_argument si la literal no es una red válida.
+		 */
+		constexpr IPv4Network operator"" _net( const char *text, std::size_t len )
+		{
+			return detail::parseIPv4Network( text, len,
+					detail::findSlash( text, len ) );
+		}
+	} // namespace literals
+} // namespace reroman
+
+#endif // REROMAN_LITERALS_HPP
@@ -9,16 +9,48 @@
 
 #include <reroman/ipv4addr.hpp>
 #include <reroman/hwaddr.hpp>
+#include <memory>
+#include <vector>
 
 namespace reroman
 {
 	/**
 	 * @brief Representación de una interfaz de red en el sistema.
+	 * @details Al asociarse a una interfaz se obtiene una instantánea de sus
+	 * datos (nombre, direcciones y banderas), de modo que los getters no
+	 * realizan llamadas al sistema. La instantánea se actualiza con refresh()
+	 * o automáticamente tras enableAutoRefresh(); las copias de un objeto
+	 * comparten la misma instantánea y pueden leerla desde varios hilos.
 	 * @headerfile networkinterface.hpp <reroman/networkinterface.hpp>
 	 */
 	class NetworkInterface
 	{
 	public:
+		/**
+		 * @brief Estado operativo de una interfaz (RFC 2863).
+		 */
+		enum class OperState: uint8_t
+		{
+			UNKNOWN,		///< Desconocido.
+			NOTPRESENT,		///< Falta algún componente.
+			DOWN,			///< Inactiva.
+			LOWERLAYERDOWN,	///< Inactiva por una interfaz inferior.
+			TESTING,		///< En modo de prueba.
+			DORMANT,		///< En espera de un evento externo.
+			UP				///< Activa.
+		};
+
+		/**
+		 * @brief Dirección IPv4 asignada a una interfaz.
+		 */
+		struct Address
+		{
+			IPv4Addr address;	///< Dirección local.
+			IPv4Addr netmask;	///< Máscara de subred.
+			IPv4Addr broadcast;	///< Dirección de difusión, nula si no tiene.
+			bool secondary;		///< Verdadero si es una dirección secundaria.
+		};
+
 		//===============================================================
 		//							Constructores
 		//===============================================================
@@ -50,8 +82,10 @@ namespace reroman
 		/**
 		 * @brief Obtiene el nombre de la interfaz de red.
 		 * @return Una cadena con el nombre de la interfaz.
+		 * @throw std::bad_alloc si no hay memoria para la cadena o para
+		 * actualizar los datos de la interfaz.
 		 */
-		std::string getName( void ) const noexcept;
+		std::string getName( void ) const;
 
 		/**
 		 * @brief Obtiene el índice de la interfaz.
@@ -60,7 +94,7 @@ namespace reroman
 		int getIndex( void ) const noexcept;
 
 		/**
-		 * @brief Obtiene la dirección IPv4 asignada a la interfaz de red.
+		 * @brief Obtiene la dirección IPv4 principal de la interfaz de red.
 		 * @return Un objeto IPv4Addr con la dirección.
 		 * @throw std::system_error si no se puede obtener la dirección
 		 * requerida.
@@ -83,8 +117,36 @@ namespace reroman
 		 */
 		HwAddr getHwAddress( void ) const;
 
+		/**
+		 * @brief Obtiene todas las direcciones IPv4 de la interfaz,
+		 * incluyendo las secundarias.
+		 * @return Las direcciones en el orden reportado por el kernel.
+		 */
+		std::vector<Address> getAddresses( void ) const;
+
+		/**
+		 * @brief Obtiene la unidad máxima de transmisión de la interfaz.
+		 * @return La MTU en bytes, o 0 si el objeto no está asociado a una
+		 * interfaz.
+		 */
+		unsigned int getMtu( void ) const;
+
+		/**
+		 * @brief Obtiene el estado operativo de la interfaz.
+		 */
+		OperState getOperState( void ) const;
+
+		/**
+		 * @brief Obtiene las banderas de la interfaz.
+		 * @return Combinación de valores IFF_*, o 0 si el objeto no está
+		 * asociado a una interfaz.
+		 */
+		unsigned int getFlags( void ) const;
+
 		/**
 		 * @brief Verifica si la interfaz está en modo promiscuo.
+		 * @details A diferencia de los demás getters consulta siempre al
+		 * sistema.
 		 * @return Verdadero si se encuentra en modo promiscuo, falso
 		 * en caso contrario.
 		 * @throw std::system_error si ocurre algún error.
@@ -106,6 +168,8 @@ namespace reroman
 		 * @brief Activa/desactiva el modo promiscuo.
 		 * @param value Un valor verdadero activa el modo promiscuo, un
 		 * valor falso lo desactiva.
+		 * @details Después del cambio se intenta actualizar la instantánea
+		 * de la interfaz; si esto falla el resultado no se ve afectado.
 		 * @return Verdadero si la acción se completó con éxito, falso
 		 * en caso contrario.
 		 */
@@ -125,19 +189,77 @@ namespace reroman
 		 */
 		bool bind( int index );
 
+
+		//===============================================================
+		//							Operaciones
+		//===============================================================
+		/**
+		 * @brief Vuelve a obtener los datos de la interfaz del sistema.
+		 * @details La nueva instantánea es visible para todas las copias del
+		 * objeto.
+		 * @return Verdadero si se actualizaron los datos, falso en caso
+		 * contrario estableciendo el valor de errno.
+		 */
+		bool refresh( void );
+
+
+		//===============================================================
+		//						Miembros Estáticos
+		//===============================================================
+		/**
+		 * @brief Inicia un hilo que escucha los cambios de interfaces y
+		 * direcciones por netlink.
+		 * @details Cada cambio invalida las instantáneas de todos los objetos,
+		 * que se actualizan en su siguiente lectura.
+		 * @return Verdadero si el hilo está en ejecución, falso en caso
+		 * contrario estableciendo el valor de errno.
+		 */
+		static bool enableAutoRefresh( void );
+
+		/**
+		 * @brief Detiene el hilo iniciado por enableAutoRefresh().
+		 */
+		static void disableAutoRefresh( void );
+
+		/**
+		 * @brief Obtiene todas las interfaces de red del sistema.
+		 * @details Utiliza un solo volcado RTM_GETLINK y uno RTM_GETADDR de
+		 * netlink, sin importar el número de interfaces ni los huecos en sus
+		 * índices.
+		 * @return Las interfaces ordenadas por índice.
+		 * @throw std::system_error si ocurre algún error.
+		 */
+		static std::vector<NetworkInterface> enumerate( void );
+
 	private:
-		std::string name;
-		int index;
-		bool binded = false;
+		struct Snapshot
+		{
+			int index = 0;
+			std::string name;
+			unsigned int flags = 0;
+			unsigned int mtu = 0;
+			OperState operState = OperState::UNKNOWN;
+			HwAddr hwAddress;
+			std::vector<Address> addresses;
+			uint64_t generation = 0;
+		};
+		struct Shared;
+
+		int index = 0;
+		std::shared_ptr<Shared> shared;
+
+		std::shared_ptr<const Snapshot> snapshot( void ) const;
+		void setSnapshot( std::shared_ptr<const Snapshot> snap );
+		static bool fetch( int index, std::vector<Snapshot> &snaps );
 	};
 
 
 	//===============================================================
 	//					Métodos Inline	
 	//===============================================================
-	inline std::string NetworkInterface::getName( void ) const noexcept
+	inline std::string NetworkInterface::getName( void ) const
 	{
-		return name;
+		return shared ? snapshot()->name : std::string();
 	}
 
 	inline int NetworkInterface::getIndex( void ) const noexcept
@@ -145,24 +267,30 @@ namespace reroman
 		return index;
 	}
 
-	inline IPv4Addr NetworkInterface::getAddress( void ) const
+	inline std::vector<NetworkInterface::Address>
+	NetworkInterface::getAddresses( void ) const
+	{
+		return shared ? snapshot()->addresses : std::vector<Address>();
+	}
+
+	inline unsigned int NetworkInterface::getMtu( void ) const
 	{
-		return IPv4Addr::getFromInterface( name );
+		return shared ? snapshot()->mtu : 0;
 	}
 
-	inline IPv4Addr NetworkInterface::getNetmask( void ) const
+	inline NetworkInterface::OperState NetworkInterface::getOperState( void ) const
 	{
-		return IPv4Addr::getNmaskFromInterface( name );
+		return shared ? snapshot()->operState : OperState::UNKNOWN;
 	}
 
-	inline HwAddr NetworkInterface::getHwAddress( void ) const
+	inline unsigned int NetworkInterface::getFlags( void ) const
 	{
-		return HwAddr::getFromInterface( name );
+		return shared ? snapshot()->flags : 0;
 	}
 
 	inline bool NetworkInterface::isBinded( void ) const
 	{
-		return binded;
+		return shared != nullptr;
 	}
 } // namespace reroman
 
@@ -0,0 +1,186 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of the  nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @file
+ * @author Ricardo Román <reroman4@gmail.com>
+ * @brief Declaración de la clase reroman::OuiDatabase.
+ */
+
+#ifndef REROMAN_OUIDATABASE_HPP
+#define REROMAN_OUIDATABASE_HPP
+
+#include <reroman/hwaddr.hpp>
+#include <string>
+#include <vector>
+
+namespace reroman
+{
+	/**
+	 * @brief Base de datos de fabricantes por prefijo de dirección física.
+	 * @details Los registros MA-L (OUI de 24 bits), MA-M (28 bits), MA-S e
+	 * IAB (36 bits) del IEEE se compilan con compile() a un archivo binario
+	 * que contiene una tabla hash de direccionamiento abierto y las cadenas
+	 * de los fabricantes sin repetir. Abrir el archivo sólo lo proyecta en
+	 * memoria con mmap() y valida su estructura, y las búsquedas devuelven
+	 * apuntadores a las cadenas dentro de la proyección, sin copiarlas.
+	 *
+	 * El archivo usa el orden de bytes de la máquina que lo compiló; uno
+	 * compilado en otra arquitectura se rechaza al abrirlo.
+	 * @headerfile ouidatabase.hpp <reroman/ouidatabase.hpp>
+	 */
+	class OuiDatabase final
+	{
+	public:
+		//===============================================================
+		//							Constructores
+		//===============================================================
+		/**
+		 * @brief Crea una base de datos sin abrir.
+		 */
+		OuiDatabase( void ) noexcept = default;
+
+		/**
+		 * @brief Abre una base de datos compilada.
+		 * @param path Ruta del archivo.
+		 * @throw std::system_error si no puede leerse el archivo.
+		 * @throw std::invalid_argument si el archivo no es una base de datos
+		 * válida.
+		 */
+		explicit OuiDatabase( const std::string &path );
+
+		OuiDatabase( OuiDatabase &&db ) noexcept;
+		OuiDatabase& operator=( OuiDatabase &&db ) noexcept;
+		OuiDatabase( const OuiDatabase& ) = delete;
+		OuiDatabase& operator=( const OuiDatabase& ) = delete;
+
+		~OuiDatabase( void );
+
+
+		//===============================================================
+		//							Getters
+		//===============================================================
+		/**
+		 * @brief Obtiene el fabricante de una dirección física.
+		 * @details Se busca primero el OUI de 24 bits y, sólo si éste tiene
+		 * asignaciones MA-M o MA-S, los prefijos de 28 y 36 bits; gana el
+		 * prefijo más largo.
+		 * @param addr Dirección física a buscar.
+		 * @return El nombre del fabricante terminado en nulo, válido
+		 * mientras la base de datos siga abierta, o nullptr si el prefijo no
+		 * está asignado o la base de datos no está abierta.
+		 */
+		const char* vendorOf( const HwAddr &addr ) const noexcept;
+
+		/**
+		 * @brief Obtiene el número de asignaciones de la base de datos.
+		 */
+		std::size_t getSize( void ) const noexcept;
+
+		/**
+		 * @brief Verifica si hay una base de datos abierta.
+		 */
+		bool isOpen( void ) const noexcept;
+
+
+		//===============================================================
+		//							Operaciones
+		//===============================================================
+		/**
+		 * @brief Abre una base de datos compilada.
+		 * @details Si ya había una abierta se cierra primero.
+		 * @param path Ruta del archivo.
+		 * @throw std::system_error si no puede leerse el archivo.
+		 * @throw std::invalid_argument si el archivo no es una base de datos
+		 * válida.
+		 */
+		void open( const std::string &path );
+
+		/**
+		 * @brief Cierra la base de datos.
+		 * @details Los apuntadores devueltos por vendorOf() dejan de ser
+		 * válidos.
+		 */
+		void close( void ) noexcept;
+
+
+		//===============================================================
+		//						Miembros Estáticos
+		//===============================================================
+		/**
+		 * @brief Compila registros del IEEE en formato CSV a una base de
+		 * datos binaria.
+		 * @details Se esperan los archivos oui.csv, mam.csv, oui36.csv o
+		 * iab.csv publicados por el IEEE, con las columnas Registry,
+		 * Assignment y Organization Name. Las filas de otros registros se
+		 * ignoran y, si una asignación se repite, gana la última. El archivo
+		 * se escribe con otro nombre y se renombra al terminar, por lo que
+		 * los procesos que tengan abierta la versión anterior no se ven
+		 * afectados.
+		 * @param registries Rutas de los archivos CSV.
+		 * @param output Ruta del archivo a generar.
+		 * @return El número de asignaciones compiladas.
+		 * @throw std::system_error si no pueden leerse los registros o
+		 * escribirse el archivo.
+		 * @throw std::invalid_argument si un registro tiene una fila
+		 * inválida; el mensaje indica el archivo y el número de línea.
+		 */
+		static std::size_t compile( const std::vector<std::string> &registries,
+				const std::string &output );
+
+	private:
+		struct Header;
+		struct Slot;
+
+		void *map = nullptr;
+		std::size_t mapSize = 0;
+		const Slot *slots = nullptr;
+		const char *names = nullptr;
+		uint32_t mask = 0;
+		uint32_t entries = 0;
+
+		const Slot* find( uint64_t key ) const noexcept;
+	};
+
+
+	//===============================================================
+	//					Métodos Inline	
+	//===============================================================
+	inline std::size_t OuiDatabase::getSize( void ) const noexcept
+	{
+		return entries;
+	}
+
+	inline bool OuiDatabase::isOpen( void ) const noexcept
+	{
+		return map != nullptr;
+	}
+} // namespace reroman
+
+#endif // REROMAN_OUIDATABASE_HPP
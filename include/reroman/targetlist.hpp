@@ -0,0 +1,167 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following disclaimer
+ *   in the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of the  nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @file
+ * @author Ricardo Román <reroman4@gmail.com>
+ * @brief Declaración de la clase reroman::TargetList.
+ */
+
+#ifndef REROMAN_TARGETLIST_HPP
+#define REROMAN_TARGETLIST_HPP
+
+#include <reroman/ipv4addr.hpp>
+#include <string>
+#include <vector>
+
+namespace reroman
+{
+	/**
+	 * @brief Lista de direcciones IPv4 objetivo leída desde texto.
+	 * @details Cada elemento del texto es una dirección en notación de puntos
+	 * o un bloque CIDR (\b a.b.c.d/n), separados por espacios, saltos de
+	 * línea, comas o punto y coma. El carácter \b # inicia un comentario
+	 * hasta el fin de la línea. Los bloques se expanden a sus direcciones de
+	 * host, es decir, sin las direcciones de red y difusión salvo en los
+	 * prefijos /31 y /32.
+	 *
+	 * Las direcciones se almacenan en un arreglo contiguo de enteros en
+	 * formato de red, sin objetos ni cadenas intermedias.
+	 * @headerfile targetlist.hpp <reroman/targetlist.hpp>
+	 */
+	class TargetList final
+	{
+	public:
+		//===============================================================
+		//							Constructores
+		//===============================================================
+		/**
+		 * @brief Crea una lista vacía.
+		 */
+		TargetList( void ) = default;
+
+		/**
+		 * @brief Crea una lista a partir de un archivo.
+		 * @param path Ruta del archivo.
+		 * @throw std::system_error si no puede leerse el archivo.
+		 * @throw std::invalid_argument si el archivo contiene un elemento
+		 * inválido.
+		 */
+		explicit TargetList( const std::string &path );
+
+
+		//===============================================================
+		//							Getters
+		//===============================================================
+		/**
+		 * @brief Obtiene el arreglo de direcciones.
+		 * @return Un apuntador a getSize() enteros en formato de red.
+		 */
+		const uint32_t* getData( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene el número de direcciones.
+		 */
+		std::size_t getSize( void ) const noexcept;
+
+		/**
+		 * @brief Obtiene una dirección de la lista.
+		 * @param index Índice de la dirección.
+		 * @throw std::out_of_range si index no es menor a getSize().
+		 */
+		IPv4Addr getAddress( std::size_t index ) const;
+
+
+		//===============================================================
+		//							Operaciones
+		//===============================================================
+		/**
+		 * @brief Agrega las direcciones de un archivo.
+		 * @details El archivo se proyecta en memoria con mmap() y se procesa
+		 * sin copiarlo.
+		 * @param path Ruta del archivo.
+		 * @return El número de direcciones agregadas.
+		 * @throw std::system_error si no puede leerse el archivo.
+		 * @throw std::invalid_argument si el archivo contiene un elemento
+		 * inválido; el mensaje indica el número de línea. Las direcciones
+		 * anteriores al error permanecen en la lista.
+		 */
+		std::size_t load( const std::string &path );
+
+		/**
+		 * @brief Agrega las direcciones contenidas en un texto.
+		 * @param text Inicio del texto.
+		 * @param len Número de caracteres.
+		 * @return El número de direcciones agregadas.
+		 * @throw std::invalid_argument si el texto contiene un elemento
+		 * inválido; el mensaje indica el número de línea.
+		 */
+		std::size_t parse( const char *text, std::size_t len );
+
+		/**
+		 * @brief Elimina todas las direcciones.
+		 */
+		void clear( void ) noexcept;
+
+
+		//===============================================================
+		//						Miembros Estáticos
+		//===============================================================
+		static constexpr int MinPrefix = 8; ///< Prefijo más corto aceptado en un bloque CIDR.
+
+	private:
+		std::vector<uint32_t> targets;
+	};
+
+
+	//===============================================================
+	//					Métodos Inline	
+	//===============================================================
+	inline const uint32_t* TargetList::getData( void ) const noexcept
+	{
+		return targets.data();
+	}
+
+	inline std::size_t TargetList::getSize( void ) const noexcept
+	{
+		return targets.size();
+	}
+
+	inline IPv4Addr TargetList::getAddress( std::size_t index ) const
+	{
+		return IPv4Addr( targets.at( index ) );
+	}
+
+	inline void TargetList::clear( void ) noexcept
+	{
+		targets.clear();
+	}
+} // namespace reroman
+
+#endif // REROMAN_TARGETLIST_HPP
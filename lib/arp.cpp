@@ -1,5 +1,11 @@
 #include <reroman/arp/arp.hpp>
+#include <reroman/literals.hpp>
 #include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
+#include <chrono>
+#include <algorithm>
 
 #include <cerrno>
 #include <cstring>
@@ -9,12 +15,117 @@
 #include <sys/socket.h>
 #include <linux/if_packet.h>
 #include <linux/if_arp.h>
+#include <linux/filter.h>
 #include <net/ethernet.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <poll.h>
+#include <fcntl.h>
 
 using namespace std;
 using namespace reroman;
 using namespace reroman::arp;
+using namespace reroman::literals;
+
+namespace
+{
+	typedef chrono::steady_clock Clock;
+
+	// Máximo de tramas por llamada a sendmmsg()/recvmmsg()
+	constexpr size_t MaxBatch = 64;
+
+	// Milisegundos de espera antes de reintentar un envío sin espacio
+	constexpr int RetryDelay = 1;
+
+	constexpr HwAddr Broadcast = "ff:ff:ff:ff:ff:ff"_mac;
+
+	// Trama ARP más larga posible: direcciones físicas de 255 bytes
+	constexpr size_t MaxFrameLen = EthernetARPFrameView::HeaderLen +
+		2 * ( 255 + IPv4Addr::IPv4AddrLen );
+
+	/*
+	 * Verifica que una trama tenga la disposición de ARPFrame. Sin un
+	 * filtro que lo garantice pueden llegar tramas con direcciones de otra
+	 * longitud, que copiadas en un ARPFrame tendrían los campos corridos.
+	 */
+	inline bool isEthernetFrame( const void *data, size_t len )
+	{
+		return EthernetARPFrameView( data, len ).isValid();
+	}
+
+	/*
+	 * Genera el programa BPF para un filtro. En un socket SOCK_DGRAM los
+	 * desplazamientos son relativos al inicio de la trama ARP. Cada
+	 * comparación fallida salta a la última instrucción, que descarta
+	 * la trama.
+	 */
+	vector<sock_filter> compileFilter( const ARPFilter &filter )
+	{
+		vector<sock_filter> prog;
+		auto check = [&prog]( uint16_t load, uint32_t offset, uint32_t value,
+				uint32_t mask ){
+			prog.push_back( BPF_STMT( load | BPF_ABS, offset ) );
+			if( mask != 0xffffffff )
+				prog.push_back( BPF_STMT( BPF_ALU | BPF_AND | BPF_K, mask ) );
+			prog.push_back( BPF_JUMP( BPF_JMP | BPF_JEQ | BPF_K, value, 0, 0 ) );
+		};
+
+		if( filter.onlyEthernetIPv4 ){
+			check( BPF_LD | BPF_H, 0, static_cast<uint16_t>(HwType::ETHER),
+					0xffffffff );
+			check( BPF_LD | BPF_H, 2, static_cast<uint16_t>(Protocol::IPV4),
+					0xffffffff );
+			check( BPF_LD | BPF_B, 4, HwAddr::HwAddrLen, 0xffffffff );
+			check( BPF_LD | BPF_B, 5, IPv4Addr::IPv4AddrLen, 0xffffffff );
+		}
+		if( filter.onlyReplies )
+			check( BPF_LD | BPF_H, 6, static_cast<uint16_t>(OperationCode::REPLY),
+					0xffffffff );
+		if( !filter.senderNetmask.isNull() )
+			check( BPF_LD | BPF_W, 14, ( filter.senderNetwork &
+						filter.senderNetmask ).toHostInt(),
+					filter.senderNetmask.toHostInt() );
+		if( !filter.targetAddr.isNull() )
+			check( BPF_LD | BPF_W, 24, filter.targetAddr.toHostInt(),
+					0xffffffff );
+
+		prog.push_back( BPF_STMT( BPF_RET | BPF_K, 0xffff ) );
+		prog.push_back( BPF_STMT( BPF_RET | BPF_K, 0 ) );
+
+		const size_t reject = prog.size() - 1;
+		for( size_t i = 0 ; i < reject ; i++ )
+			if( BPF_CLASS( prog[i].code ) == BPF_JMP )
+				prog[i].jf = reject - i - 1;
+		return prog;
+	}
+
+	/*
+	 * Espera a que haya datos disponibles en el socket. Si deadline es
+	 * null espera indefinidamente. Regresa falso si se alcanzó el
+	 * tiempo límite.
+	 */
+	bool waitReadable( int sfd, const Clock::time_point *deadline )
+	{
+		struct pollfd pfd{ sfd, POLLIN, 0 };
+
+		while( true ){
+			int wait = -1;
+			if( deadline ){
+				auto now = Clock::now();
+				if( now >= *deadline )
+					return false;
+				wait = chrono::duration_cast<chrono::milliseconds>(
+						*deadline - now ).count() + 1;
+			}
+
+			int ready = poll( &pfd, 1, wait );
+			if( ready > 0 )
+				return true;
+			if( ready < 0 && errno != EINTR )
+				throw system_error( errno, generic_category(), "poll" );
+		}
+	}
+}
 
 namespace reroman{
 	namespace arp{
@@ -111,6 +222,9 @@ ARPSocket::ARPSocket( unsigned int msecs )
 
 ARPSocket::~ARPSocket()
 {
+	disableUring();
+	if( ring )
+		munmap( ring, ringBlockSize * ringBlockCount );
 	if( sock > 0 )
 		close( sock );
 }
@@ -128,32 +242,439 @@ bool ARPSocket::setTimeout( unsigned int msecs )
 	return true;
 }
 
+bool ARPSocket::setNonBlocking( bool value )
+{
+	int flags = fcntl( sock, F_GETFL );
+
+	if( flags < 0 )
+		return false;
+	flags = value ? flags | O_NONBLOCK : flags & ~O_NONBLOCK;
+	if( fcntl( sock, F_SETFL, flags ) < 0 )
+		return false;
+	nonBlocking = value;
+	return true;
+}
+
+bool ARPSocket::enableRxRing( unsigned int blockSize, unsigned int blockCount,
+		unsigned int retireMsecs )
+{
+	const unsigned int frameSize = TPACKET_ALIGNMENT << 7;
+	struct tpacket_req3 req;
+	int version = TPACKET_V3;
+
+	if( ring || uring ){
+		errno = EBUSY;
+		return false;
+	}
+	if( !blockCount || blockSize < frameSize || blockSize % frameSize ){
+		errno = EINVAL;
+		return false;
+	}
+
+	memset( &req, 0, sizeof(req) );
+	req.tp_block_size = blockSize;
+	req.tp_block_nr = blockCount;
+	req.tp_frame_size = frameSize;
+	req.tp_frame_nr = blockSize / frameSize * blockCount;
+	req.tp_retire_blk_tov = retireMsecs;
+
+	if( setsockopt( sock, SOL_PACKET, PACKET_VERSION,
+				&version, sizeof(version) ) < 0 ||
+			setsockopt( sock, SOL_PACKET, PACKET_RX_RING,
+				&req, sizeof(req) ) < 0 )
+		return false;
+
+	void *mem = mmap( nullptr, static_cast<size_t>(blockSize) * blockCount,
+			PROT_READ | PROT_WRITE, MAP_SHARED, sock, 0 );
+	if( mem == MAP_FAILED ){
+		int err = errno;
+		memset( &req, 0, sizeof(req) );
+		setsockopt( sock, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req) );
+		errno = err;
+		return false;
+	}
+
+	ring = static_cast<uint8_t*>( mem );
+	ringBlockSize = blockSize;
+	ringBlockCount = blockCount;
+	ringBlock = 0;
+	ringPacket = nullptr;
+	ringPending = 0;
+	return true;
+}
+
+void ARPSocket::disableRxRing( void ) noexcept
+{
+	struct tpacket_req3 req;
+
+	if( !ring )
+		return;
+	munmap( ring, ringBlockSize * ringBlockCount );
+	memset( &req, 0, sizeof(req) );
+	setsockopt( sock, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req) );
+	ring = nullptr;
+	ringPacket = nullptr;
+	ringPending = 0;
+}
+
 ARPSocket& ARPSocket::operator=( ARPSocket && sock )
 {
+	disableRxRing();
+	disableUring();
 	close( this->sock );
 	this->sock = sock.sock;
+	discarded = sock.discarded;
+	nonBlocking = sock.nonBlocking;
+	ring = sock.ring;
+	ringBlockSize = sock.ringBlockSize;
+	ringBlockCount = sock.ringBlockCount;
+	ringBlock = sock.ringBlock;
+	ringPacket = sock.ringPacket;
+	ringPending = sock.ringPending;
+	uring = sock.uring;
 	sock.sock = -1;
+	sock.ring = nullptr;
+	sock.uring = nullptr;
 	return *this;
 }
 
+uint8_t* ARPSocket::readyBlock( void ) noexcept
+{
+	uint8_t *block = ring + ringBlock * ringBlockSize;
+	auto desc = reinterpret_cast<tpacket_block_desc*>( block );
+
+	if( !(desc->hdr.bh1.block_status & TP_STATUS_USER) )
+		return nullptr;
+	__sync_synchronize();
+	return block;
+}
+
+void ARPSocket::releaseBlock( void ) noexcept
+{
+	auto desc = reinterpret_cast<tpacket_block_desc*>(
+			ring + ringBlock * ringBlockSize );
+
+	__sync_synchronize();
+	desc->hdr.bh1.block_status = TP_STATUS_KERNEL;
+	ringBlock = ( ringBlock + 1 ) % ringBlockCount;
+	ringPacket = nullptr;
+	ringPending = 0;
+}
+
+bool ARPSocket::nextFrame( ARPFrame &frame, struct sockaddr_ll &sll )
+{
+	if( uring )
+		return uringNext( frame, sll );
+	if( !ring ){
+		while( true ){
+			socklen_t size = sizeof(sll);
+			ssize_t len = recvfrom( sock, &frame, sizeof(ARPFrame),
+					MSG_DONTWAIT | MSG_TRUNC, (sockaddr*) &sll, &size );
+
+			if( len > 0 ){
+				if( isEthernetFrame( &frame, len ) )
+					return true;
+				continue;
+			}
+			if( errno == EAGAIN || errno == EWOULDBLOCK )
+				return false;
+			if( errno != EINTR )
+				throw system_error( errno, generic_category(),
+						"ARPSocket::receive" );
+		}
+	}
+
+	while( true ){
+		if( !ringPacket ){
+			uint8_t *block = readyBlock();
+			if( !block )
+				return false;
+
+			auto desc = reinterpret_cast<tpacket_block_desc*>( block );
+			ringPending = desc->hdr.bh1.num_pkts;
+			if( !ringPending ){
+				releaseBlock();
+				continue;
+			}
+			ringPacket = block + desc->hdr.bh1.offset_to_first_pkt;
+		}
+
+		auto hdr = reinterpret_cast<tpacket3_hdr*>( ringPacket );
+		bool valid = isEthernetFrame( ringPacket + hdr->tp_mac,
+				hdr->tp_snaplen );
+		if( valid ){
+			memcpy( &frame, ringPacket + hdr->tp_mac, sizeof(ARPFrame) );
+			memcpy( &sll, ringPacket + TPACKET_ALIGN(sizeof(tpacket3_hdr)),
+					sizeof(sll) );
+		}
+
+		if( --ringPending )
+			ringPacket += hdr->tp_next_offset;
+		else
+			releaseBlock();
+		if( valid )
+			return true;
+	}
+}
+
 bool ARPSocket::receive( ARPFrame &frame, HwAddr *sender )
 {
 	struct sockaddr_ll sll{ 0, 0, 0, 0, 0, 0, 0 };
-	socklen_t size = sizeof(sll);
+	const int msecs = getTimeout();
+	const Clock::time_point deadline = Clock::now() +
+		chrono::milliseconds( msecs );
 
-	if( recvfrom( sock, &frame, sizeof(ARPFrame), 0,
-				(sockaddr*) &sll, &size ) <= 0 ){
-		if( errno == EAGAIN )
-			return false;
-		else
+	if( ring || uring ){
+		while( !nextFrame( frame, sll ) )
+			if( nonBlocking || !waitReadable( getEventHandle(), msecs ? &deadline : nullptr ) )
+				return false;
+	}
+	else{
+		bool dropped = false;
+
+		while( true ){
+			// Tras descartar una trama se espera con poll() para no reiniciar
+			// el tiempo de espera del socket
+			socklen_t size = sizeof(sll);
+			ssize_t len = recvfrom( sock, &frame, sizeof(ARPFrame),
+					MSG_TRUNC | ( dropped ? MSG_DONTWAIT : 0 ),
+					(sockaddr*) &sll, &size );
+			if( len >= 0 ){
+				if( isEthernetFrame( &frame, len ) )
+					break;
+				dropped = true;
+				continue;
+			}
+			if( errno == EINTR )
+				continue;
+			if( errno == EAGAIN || errno == EWOULDBLOCK ){
+				if( nonBlocking || !dropped ||
+						!waitReadable( sock, msecs ? &deadline : nullptr ) )
+					return false;
+				continue;
+			}
 			throw system_error( errno, generic_category(),
 					"ARPSocket::receive" );
+		}
 	}
 	if( sender )
 		sender->setData( sll.sll_addr );
 	return true;
 }
 
+size_t ARPSocket::receiveRing( const FrameHandler &handler )
+{
+	const int msecs = getTimeout();
+	const Clock::time_point deadline = Clock::now() +
+		chrono::milliseconds( msecs );
+	size_t count = 0;
+
+	if( !ring ){
+		ARPFrame frame;
+		struct sockaddr_ll sll;
+
+		while( !nextFrame( frame, sll ) )
+			if( nonBlocking || !waitReadable( getEventHandle(), msecs ? &deadline : nullptr ) )
+				return 0;
+		do{
+			count++;
+			if( handler )
+				handler( frame, HwAddr( sll.sll_addr ) );
+		}while( nextFrame( frame, sll ) );
+		return count;
+	}
+
+	while( !ringPacket && !readyBlock() )
+		if( nonBlocking || !waitReadable( getEventHandle(), msecs ? &deadline : nullptr ) )
+			return 0;
+
+	while( ringPacket || readyBlock() ){
+		if( !ringPacket ){
+			auto desc = reinterpret_cast<tpacket_block_desc*>(
+					ring + ringBlock * ringBlockSize );
+			ringPending = desc->hdr.bh1.num_pkts;
+			ringPacket = reinterpret_cast<uint8_t*>( desc ) +
+				desc->hdr.bh1.offset_to_first_pkt;
+		}
+
+		for( ; ringPending ; ringPending-- ){
+			auto hdr = reinterpret_cast<tpacket3_hdr*>( ringPacket );
+			if( isEthernetFrame( ringPacket + hdr->tp_mac, hdr->tp_snaplen ) ){
+				auto sll = reinterpret_cast<sockaddr_ll*>( ringPacket +
+						TPACKET_ALIGN(sizeof(tpacket3_hdr)) );
+				count++;
+				if( handler )
+					handler( *reinterpret_cast<const ARPFrame*>(
+								ringPacket + hdr->tp_mac ),
+							HwAddr( sll->sll_addr ) );
+			}
+			ringPacket += hdr->tp_next_offset;
+		}
+		releaseBlock();
+	}
+	return count;
+}
+
+size_t ARPSocket::receiveViews( const FrameViewHandler &handler )
+{
+	const int msecs = getTimeout();
+	const Clock::time_point deadline = Clock::now() +
+		chrono::milliseconds( msecs );
+	size_t count = 0;
+
+	if( uring ){
+		ARPFrame frame;
+		struct sockaddr_ll sll;
+
+		while( !nextFrame( frame, sll ) )
+			if( nonBlocking || !waitReadable( getEventHandle(), msecs ? &deadline : nullptr ) )
+				return 0;
+		do{
+			count++;
+			if( handler )
+				handler( ARPFrameView( &frame, sizeof(ARPFrame) ) );
+		}while( nextFrame( frame, sll ) );
+		return count;
+	}
+
+	if( !ring ){
+		uint8_t buffer[MaxFrameLen];
+
+		// Se espera con poll() para que las tramas descartadas no reinicien
+		// el tiempo de espera del socket
+		while( true ){
+			ssize_t len = recv( sock, buffer, sizeof(buffer), MSG_DONTWAIT );
+
+			if( len < 0 ){
+				if( errno == EINTR )
+					continue;
+				if( errno != EAGAIN && errno != EWOULDBLOCK )
+					throw system_error( errno, generic_category(),
+							"ARPSocket::receiveViews" );
+				// Tras la primer trama sólo se vacía la cola del socket
+				if( count || nonBlocking ||
+						!waitReadable( sock, msecs ? &deadline : nullptr ) )
+					return count;
+				continue;
+			}
+
+			ARPFrameView view( buffer, len );
+			if( view ){
+				count++;
+				if( handler )
+					handler( view );
+			}
+		}
+	}
+
+	while( !ringPacket && !readyBlock() )
+		if( nonBlocking || !waitReadable( getEventHandle(), msecs ? &deadline : nullptr ) )
+			return 0;
+
+	while( ringPacket || readyBlock() ){
+		if( !ringPacket ){
+			auto desc = reinterpret_cast<tpacket_block_desc*>(
+					ring + ringBlock * ringBlockSize );
+			ringPending = desc->hdr.bh1.num_pkts;
+			ringPacket = reinterpret_cast<uint8_t*>( desc ) +
+				desc->hdr.bh1.offset_to_first_pkt;
+		}
+
+		for( ; ringPending ; ringPending-- ){
+			auto hdr = reinterpret_cast<tpacket3_hdr*>( ringPacket );
+			ARPFrameView view( ringPacket + hdr->tp_mac, hdr->tp_snaplen );
+			if( view ){
+				count++;
+				if( handler )
+					handler( view );
+			}
+			ringPacket += hdr->tp_next_offset;
+		}
+		releaseBlock();
+	}
+	return count;
+}
+
+size_t ARPSocket::receiveBatch( ARPFrame *frames, size_t count,
+		HwAddr *senders )
+{
+	struct sockaddr_ll sll[MaxBatch];
+	const int msecs = getTimeout();
+	const Clock::time_point deadline = Clock::now() +
+		chrono::milliseconds( msecs );
+	size_t received = 0;
+	bool dropped = false;
+
+	if( !count )
+		return 0;
+
+	if( ring || uring ){
+		while( !nextFrame( frames[0], sll[0] ) )
+			if( nonBlocking || !waitReadable( getEventHandle(), msecs ? &deadline : nullptr ) )
+				return 0;
+		do{
+			if( senders )
+				senders[received].setData( sll[0].sll_addr );
+		}while( ++received < count && nextFrame( frames[received], sll[0] ) );
+		return received;
+	}
+
+	struct mmsghdr msgs[MaxBatch];
+	struct iovec iovs[MaxBatch];
+
+	while( received < count ){
+		size_t n = min( count - received, MaxBatch );
+
+		memset( msgs, 0, sizeof(mmsghdr) * n );
+		for( size_t i = 0 ; i < n ; i++ ){
+			iovs[i].iov_base = frames + received + i;
+			iovs[i].iov_len = sizeof(ARPFrame);
+			msgs[i].msg_hdr.msg_name = &sll[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(sll[i]);
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		// Sólo la primer llamada espera por tramas. Si todas las recibidas
+		// se descartaron, la espera sigue con poll() hasta el tiempo límite
+		int res = recvmmsg( sock, msgs, n, MSG_TRUNC |
+				( received || dropped ? MSG_DONTWAIT : MSG_WAITFORONE ), nullptr );
+		if( res <= 0 ){
+			if( errno == EINTR )
+				continue;
+			if( errno == EAGAIN || errno == EWOULDBLOCK ){
+				if( !received && dropped && !nonBlocking &&
+						waitReadable( sock, msecs ? &deadline : nullptr ) )
+					continue;
+				break;
+			}
+			throw system_error( errno, generic_category(),
+					"ARPSocket::receiveBatch" );
+		}
+
+		// Compacta las tramas válidas al inicio del lote
+		size_t kept = 0;
+		for( int i = 0 ; i < res ; i++ ){
+			ARPFrame &frame = frames[received + i];
+			if( !isEthernetFrame( &frame, msgs[i].msg_len ) )
+				continue;
+			if( kept != static_cast<size_t>(i) )
+				frames[received + kept] = frame;
+			if( senders )
+				senders[received + kept].setData( sll[i].sll_addr );
+			kept++;
+		}
+		received += kept;
+		if( !received ){
+			dropped = true;
+			continue;
+		}
+		if( static_cast<size_t>(res) < n )
+			break;
+	}
+	return received;
+}
+
 bool ARPSocket::send( const ARPFrame &frame, const HwAddr &dst,
 	   const NetworkInterface &nic )
 {
@@ -161,12 +682,55 @@ bool ARPSocket::send( const ARPFrame &frame, const HwAddr &dst,
 		htons( ETH_P_ARP ),
 		nic.getIndex(),
 		0, 0, HwAddr::HwAddrLen, 0 };
+	if( uring )
+		return uringSend( &frame, 1, dst, nic ) == 1;
 	dst.copyTo( sll.sll_addr );
 
 	return sendto( sock, &frame, sizeof(ARPFrame), 0,
 				(sockaddr*) &sll, sizeof(sll) ) > 0;
 }
 
+size_t ARPSocket::sendBatch( const ARPFrame *frames, size_t count,
+		const HwAddr &dst, const NetworkInterface &nic )
+{
+	struct sockaddr_ll sll{ AF_PACKET,
+		htons( ETH_P_ARP ),
+		nic.getIndex(),
+		0, 0, HwAddr::HwAddrLen, 0 };
+	struct mmsghdr msgs[MaxBatch];
+	struct iovec iovs[MaxBatch];
+	size_t sent = 0;
+
+	if( uring )
+		return uringSend( frames, count, dst, nic );
+	dst.copyTo( sll.sll_addr );
+	memset( msgs, 0, sizeof(msgs) );
+	for( size_t i = 0 ; i < MaxBatch ; i++ ){
+		iovs[i].iov_len = sizeof(ARPFrame);
+		msgs[i].msg_hdr.msg_name = &sll;
+		msgs[i].msg_hdr.msg_namelen = sizeof(sll);
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	while( sent < count ){
+		size_t n = min( count - sent, MaxBatch );
+		for( size_t i = 0 ; i < n ; i++ )
+			iovs[i].iov_base = const_cast<ARPFrame*>( frames + sent + i );
+
+		int res = sendmmsg( sock, msgs, n, 0 );
+		if( res < 0 ){
+			if( errno == EINTR )
+				continue;
+			break;
+		}
+		// Un envío parcial no cambia errno; se reintenta el resto para que
+		// la siguiente llamada informe el error, si lo hay
+		sent += res;
+	}
+	return sent;
+}
+
 bool ARPSocket::bind( const NetworkInterface &nic )
 {
 	struct sockaddr_ll sll{ AF_PACKET,
@@ -178,26 +742,202 @@ bool ARPSocket::bind( const NetworkInterface &nic )
 	return !::bind( sock, (sockaddr*) &sll, sizeof(sll) );
 }
 
+bool ARPSocket::joinFanout( uint16_t group, FanoutMode mode )
+{
+	int arg = group | static_cast<int>( mode ) << 16;
+
+	return !setsockopt( sock, SOL_PACKET, PACKET_FANOUT, &arg, sizeof(arg) );
+}
+
+bool ARPSocket::createFanout( uint16_t &group, FanoutMode mode )
+{
+	int arg = static_cast<int>( mode ) << 16 |
+		PACKET_FANOUT_FLAG_UNIQUEID << 16;
+	socklen_t size = sizeof(arg);
+
+	if( setsockopt( sock, SOL_PACKET, PACKET_FANOUT, &arg, sizeof(arg) ) < 0 ||
+			getsockopt( sock, SOL_PACKET, PACKET_FANOUT, &arg, &size ) < 0 )
+		return false;
+	group = arg & 0xffff;
+	return true;
+}
+
+bool ARPSocket::setFilter( const ARPFilter &filter )
+{
+	struct sock_filter dropAll = BPF_STMT( BPF_RET | BPF_K, 0 );
+	struct sock_fprog fprog{ 1, &dropAll };
+	vector<sock_filter> prog = compileFilter( filter );
+
+	// Descarta las tramas recibidas antes de que el filtro estuviera activo
+	if( setsockopt( sock, SOL_SOCKET, SO_ATTACH_FILTER,
+				&fprog, sizeof(fprog) ) < 0 )
+		return false;
+
+	// Si algo falla, el socket no debe quedar con el filtro que lo descarta
+	// todo
+	try{
+		ARPFrame frame;
+		struct sockaddr_ll sll;
+		while( nextFrame( frame, sll ) )
+			;
+	}
+	catch( ... ){
+		clearFilter();
+		throw;
+	}
+
+	fprog.len = prog.size();
+	fprog.filter = prog.data();
+	if( setsockopt( sock, SOL_SOCKET, SO_ATTACH_FILTER,
+				&fprog, sizeof(fprog) ) < 0 ){
+		int err = errno;
+		clearFilter();
+		errno = err;
+		return false;
+	}
+	return true;
+}
+
+bool ARPSocket::clearFilter( void )
+{
+	int dummy = 0;
+
+	return !setsockopt( sock, SOL_SOCKET, SO_DETACH_FILTER,
+			&dummy, sizeof(dummy) );
+}
+
 bool ARPSocket::resolve( const IPv4Addr &ip,
 		const NetworkInterface &nic, HwAddr *result )
 {
 	ARPFrame frame;
-	const HwAddr broadcast{ 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
 
 	frame.setSourceHwAddr( nic.getHwAddress() );
 	frame.ipSrc = nic.getAddress().toNetworkInt();
 	frame.ipTgt = ip.toNetworkInt();
 
-	if( !send( frame, broadcast, nic ) )
+	discarded = 0;
+	if( !send( frame, Broadcast, nic ) )
 		return false;
 
-	if( receive( frame ) && 
-			frame.getOpCode() == OperationCode::REPLY &&
-			frame.ipSrc == ip.toNetworkInt() ){
-		if( result )
-			result->setData( frame.hwSrc );
-		return true;
+	const int msecs = getTimeout();
+	const Clock::time_point deadline = Clock::now() +
+		chrono::milliseconds( msecs );
+	const uint32_t target = ip.toNetworkInt();
+
+	while( true ){
+		struct sockaddr_ll sll;
+
+		if( !nextFrame( frame, sll ) ){
+			if( !waitReadable( getEventHandle(), msecs ? &deadline : nullptr ) )
+				return false;
+			continue;
+		}
+
+		if( sll.sll_ifindex == nic.getIndex() &&
+				frame.getOpCode() == OperationCode::REPLY &&
+				frame.ipSrc == target ){
+			if( result )
+				result->setData( frame.hwSrc );
+			return true;
+		}
+		discarded++;
 	}
-	return false;
 }
 
+
+size_t ARPSocket::resolveMany( const vector<IPv4Addr> &targets,
+		const NetworkInterface &nic, const ResolveHandler &handler,
+		size_t window )
+{
+	ARPFrame frame;
+	const chrono::milliseconds timeout( getTimeout() );
+	unordered_map<uint32_t, Clock::time_point> pending;
+	unordered_set<uint32_t> seen;
+	deque<pair<uint32_t, Clock::time_point>> expiry;
+	size_t next = 0;
+	size_t resolved = 0;
+
+	if( !window )
+		window = 1;
+	frame.setSourceHwAddr( nic.getHwAddress() );
+	frame.ipSrc = nic.getAddress().toNetworkInt();
+
+	while( next < targets.size() || !pending.empty() ){
+		bool blocked = false;
+
+		// Llena la ventana de peticiones pendientes
+		while( next < targets.size() && pending.size() < window ){
+			const uint32_t target = targets[next].toNetworkInt();
+			if( seen.count( target ) ){
+				next++;
+				continue;
+			}
+			frame.ipTgt = target;
+			if( !send( frame, Broadcast, nic ) ){
+				if( errno == ENOBUFS || errno == EAGAIN ){
+					blocked = true;
+					break;
+				}
+				throw system_error( errno, generic_category(),
+						"ARPSocket::resolveMany" );
+			}
+			auto deadline = Clock::now() + timeout;
+			seen.insert( target );
+			pending[target] = deadline;
+			if( timeout.count() )
+				expiry.emplace_back( target, deadline );
+			next++;
+		}
+
+		// Descarta las peticiones cuyo tiempo de espera terminó
+		auto now = Clock::now();
+		while( !expiry.empty() && expiry.front().second <= now ){
+			auto it = pending.find( expiry.front().first );
+			if( it != pending.end() && it->second == expiry.front().second )
+				pending.erase( it );
+			expiry.pop_front();
+		}
+		if( pending.empty() && !blocked )
+			continue;
+
+		// Espera respuestas hasta la expiración más próxima. Si la cola de
+		// envío está llena se espera un poco antes de reintentar
+		int wait = -1;
+		if( blocked )
+			wait = RetryDelay;
+		else if( next < targets.size() && pending.size() < window )
+			wait = 0;
+		else if( !expiry.empty() )
+			wait = chrono::duration_cast<chrono::milliseconds>(
+					expiry.front().second - now ).count() + 1;
+
+		struct pollfd pfd{ getEventHandle(), POLLIN, 0 };
+		int ready = poll( &pfd, 1, wait );
+		if( ready < 0 ){
+			if( errno == EINTR )
+				continue;
+			throw system_error( errno, generic_category(),
+					"ARPSocket::resolveMany" );
+		}
+		if( !ready )
+			continue;
+
+		ARPFrame reply;
+		struct sockaddr_ll sll;
+		while( nextFrame( reply, sll ) ){
+			if( sll.sll_ifindex != nic.getIndex() ||
+					reply.getOpCode() != OperationCode::REPLY )
+				continue;
+
+			const uint32_t source = reply.ipSrc;
+			auto it = pending.find( source );
+			if( it == pending.end() )
+				continue;
+			pending.erase( it );
+			resolved++;
+			if( handler )
+				handler( IPv4Addr( source ), HwAddr( reply.hwSrc ) );
+		}
+	}
+	return resolved;
+}
@@ -0,0 +1,164 @@
+#include <reroman/arp/arpbulksender.hpp>
+#include <system_error>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+#include <poll.h>
+
+using namespace std;
+using namespace reroman;
+using namespace reroman::arp;
+
+namespace
+{
+	// Desplazamiento de los datos dentro de una ranura TPACKET_V2 de envío.
+	constexpr size_t DataOffset = TPACKET_ALIGN( sizeof(tpacket2_hdr) );
+	constexpr size_t FrameLen = sizeof(ether_header) + sizeof(ARPFrame);
+}
+
+ARPBulkSender::ARPBulkSender( const NetworkInterface &nic, unsigned int frames,
+		bool qdiscBypass )
+{
+	const size_t blockSize = sysconf( _SC_PAGESIZE );
+	int version = TPACKET_V2;
+	int bypass = 1;
+	struct tpacket_req req;
+
+	frameSize = TPACKET_ALIGNMENT << 3;
+	frameCount = ( frames + blockSize / frameSize - 1 ) /
+		( blockSize / frameSize ) * ( blockSize / frameSize );
+	if( !frameCount )
+		frameCount = blockSize / frameSize;
+	ringSize = frameCount * frameSize;
+
+	sock = socket( AF_PACKET, SOCK_RAW, 0 );
+	if( sock < 0 )
+		throw system_error( errno, generic_category(), "ARPBulkSender" );
+
+	struct sockaddr_ll sll{ AF_PACKET, 0, nic.getIndex(), 0, 0, 0, 0 };
+	req.tp_block_size = blockSize;
+	req.tp_block_nr = ringSize / blockSize;
+	req.tp_frame_size = frameSize;
+	req.tp_frame_nr = frameCount;
+
+	if( setsockopt( sock, SOL_PACKET, PACKET_VERSION,
+				&version, sizeof(version) ) < 0 ||
+			( qdiscBypass && setsockopt( sock, SOL_PACKET, PACKET_QDISC_BYPASS,
+				&bypass, sizeof(bypass) ) < 0 ) ||
+			setsockopt( sock, SOL_PACKET, PACKET_TX_RING,
+				&req, sizeof(req) ) < 0 ||
+			::bind( sock, (sockaddr*) &sll, sizeof(sll) ) < 0 ){
+		int err = errno;
+		close( sock );
+		throw system_error( err, generic_category(), "ARPBulkSender" );
+	}
+
+	void *mem = mmap( nullptr, ringSize, PROT_READ | PROT_WRITE,
+			MAP_SHARED, sock, 0 );
+	if( mem == MAP_FAILED ){
+		int err = errno;
+		close( sock );
+		throw system_error( err, generic_category(), "ARPBulkSender" );
+	}
+	ring = static_cast<uint8_t*>( mem );
+
+	// Cada ranura contiene desde el inicio la petición completa
+	struct ether_header eth;
+	ARPFrame frame;
+	const HwAddr hw = nic.getHwAddress();
+
+	memset( eth.ether_dhost, 0xff, ETH_ALEN );
+	hw.copyTo( eth.ether_shost );
+	eth.ether_type = htons( ETH_P_ARP );
+	frame.setSourceHwAddr( hw );
+	frame.setSourceIPAddr( nic.getAddress() );
+
+	for( size_t i = 0 ; i < frameCount ; i++ ){
+		uint8_t *data = ring + i * frameSize + DataOffset;
+		memcpy( data, &eth, sizeof(eth) );
+		memcpy( data + sizeof(eth), &frame, sizeof(frame) );
+	}
+}
+
+ARPBulkSender::~ARPBulkSender()
+{
+	munmap( ring, ringSize );
+	close( sock );
+}
+
+bool ARPBulkSender::queue( const IPv4Addr &ip ) noexcept
+{
+	uint8_t *slot = ring + head * frameSize;
+	auto hdr = reinterpret_cast<tpacket2_hdr*>( slot );
+	const uint32_t target = ip.toNetworkInt();
+
+	// El kernel nunca libera una ranura rechazada, queda a cargo de quien
+	// la vuelva a ocupar
+	if( hdr->tp_status == TP_STATUS_WRONG_FORMAT )
+		errors++;
+	else if( hdr->tp_status != TP_STATUS_AVAILABLE )
+		return false;
+
+	memcpy( slot + DataOffset + sizeof(ether_header) +
+			offsetof(ARPFrame, ipTgt), &target, sizeof(target) );
+	hdr->tp_len = FrameLen;
+	__sync_synchronize();
+	hdr->tp_status = TP_STATUS_SEND_REQUEST;
+
+	head = ( head + 1 ) % frameCount;
+	queued++;
+	return true;
+}
+
+size_t ARPBulkSender::flush( void )
+{
+	if( !queued )
+		return 0;
+
+	while( ::send( sock, nullptr, 0, 0 ) < 0 ){
+		if( errno == EINTR )
+			continue;
+		if( errno != EAGAIN && errno != ENOBUFS )
+			throw system_error( errno, generic_category(),
+					"ARPBulkSender::flush" );
+
+		// La cola del dispositivo está llena. POLLOUT sólo indica ranuras
+		// libres en el anillo, así que se espera un tiempo fijo antes de
+		// reintentar
+		if( poll( nullptr, 0, 1 ) < 0 && errno != EINTR )
+			throw system_error( errno, generic_category(),
+					"ARPBulkSender::flush" );
+	}
+
+	size_t sent = queued;
+	queued = 0;
+	return sent;
+}
+
+size_t ARPBulkSender::probe( const vector<IPv4Addr> &targets )
+{
+	size_t sent = 0;
+
+	for( auto &ip : targets ){
+		while( !queue( ip ) ){
+			if( queued ){
+				sent += flush();
+				continue;
+			}
+			// El kernel aún no libera la ranura
+			struct pollfd pfd{ sock, POLLOUT, 0 };
+			if( poll( &pfd, 1, 1 ) < 0 && errno != EINTR )
+				throw system_error( errno, generic_category(),
+						"ARPBulkSender::probe" );
+		}
+	}
+	return sent + flush();
+}
@@ -0,0 +1,297 @@
+#include <reroman/arp/arpreactor.hpp>
+#include <reroman/literals.hpp>
+#include <system_error>
+#include <vector>
+
+#include <cerrno>
+
+#include <unistd.h>
+#include <sys/epoll.h>
+
+using namespace std;
+using namespace reroman;
+using namespace reroman::arp;
+using namespace reroman::literals;
+
+namespace
+{
+	// Máximo de eventos atendidos por llamada a epoll_wait()
+	constexpr int MaxEvents = 64;
+
+	constexpr HwAddr Broadcast = "ff:ff:ff:ff:ff:ff"_mac;
+
+	inline uint64_t pendingKey( int fd, uint32_t ip ) noexcept
+	{
+		return static_cast<uint64_t>( fd ) << 32 | ip;
+	}
+}
+
+ARPReactor::ARPReactor( void )
+{
+	epfd = epoll_create1( EPOLL_CLOEXEC );
+	if( epfd < 0 )
+		throw system_error( errno, generic_category(), "ARPReactor" );
+}
+
+ARPReactor::~ARPReactor()
+{
+	close( epfd );
+}
+
+bool ARPReactor::add( int fd, function<void( void )> handler )
+{
+	struct epoll_event ev;
+
+	ev.events = EPOLLIN;
+	ev.data.fd = fd;
+	if( epoll_ctl( epfd, EPOLL_CTL_ADD, fd, &ev ) < 0 )
+		return false;
+	handles[fd] = make_shared<function<void( void )>>( move(handler) );
+	return true;
+}
+
+bool ARPReactor::add( ARPSocket &sock, ARPSocket::FrameHandler handler )
+{
+	const int fd = sock.getEventHandle();
+	ARPSocket *ptr = &sock;
+
+	if( !sock.setNonBlocking( true ) )
+		return false;
+
+	return add( fd, [this, ptr, fd, handler]( void ){
+			ptr->receiveRing( [this, fd, &handler]( const ARPFrame &frame,
+					const HwAddr &sender ){
+				dispatch( fd, frame, sender );
+				if( handler )
+					handler( frame, sender );
+			} );
+		} );
+}
+
+bool ARPReactor::remove( int fd )
+{
+	auto it = handles.find( fd );
+
+	if( it == handles.end() )
+		return false;
+
+	epoll_ctl( epfd, EPOLL_CTL_DEL, fd, nullptr );
+	handles.erase( it );
+	return true;
+}
+
+bool ARPReactor::remove( ARPSocket &sock )
+{
+	const int fd = sock.getEventHandle();
+
+	if( !remove( fd ) )
+		return false;
+	sock.setNonBlocking( false );
+
+	auto w = waiters.find( fd );
+	if( w != waiters.end() ){
+		for( auto &waiter : w->second )
+			cancelTimer( waiter.timer );
+		waiters.erase( w );
+	}
+
+	for( auto p = pending.begin() ; p != pending.end() ; ){
+		if( static_cast<int>( p->first >> 32 ) == fd ){
+			cancelTimer( p->second.timer );
+			p = pending.erase( p );
+		}
+		else
+			++p;
+	}
+	return true;
+}
+
+ARPReactor::TimerId ARPReactor::addTimer( unsigned int msecs,
+		TimerHandler handler )
+{
+	const Clock::time_point deadline = Clock::now() +
+		chrono::milliseconds( msecs );
+	const TimerId id = nextTimer++;
+
+	timers.emplace( make_pair( deadline, id ), move(handler) );
+	timerIndex.emplace( id, deadline );
+	return id;
+}
+
+bool ARPReactor::cancelTimer( TimerId id )
+{
+	auto it = timerIndex.find( id );
+
+	if( it == timerIndex.end() )
+		return false;
+	timers.erase( make_pair( it->second, id ) );
+	timerIndex.erase( it );
+	return true;
+}
+
+bool ARPReactor::resolve( ARPSocket &sock, const IPv4Addr &ip,
+		const NetworkInterface &nic, ResolveCallback callback )
+{
+	const int fd = sock.getEventHandle();
+	const uint64_t key = pendingKey( fd, ip.toNetworkInt() );
+	ARPFrame frame;
+	TimerId timer = 0;
+
+	if( !handles.count( fd ) ){
+		errno = EINVAL;
+		return false;
+	}
+
+	frame.setSourceHwAddr( nic.getHwAddress() );
+	frame.setSourceIPAddr( nic.getAddress() );
+	frame.setTargetIPAddr( ip );
+	if( !sock.send( frame, Broadcast, nic ) )
+		return false;
+
+	if( sock.getTimeout() ){
+		// El identificador que addTimer() asignará al temporizador
+		timer = nextTimer;
+		addTimer( sock.getTimeout(), [this, key, timer, ip]( void ){
+				auto range = pending.equal_range( key );
+				for( auto it = range.first ; it != range.second ; ++it ){
+					if( it->second.timer != timer )
+						continue;
+					auto cb = move( it->second.callback );
+					pending.erase( it );
+					if( cb )
+						cb( ip, nullptr );
+					return;
+				}
+			} );
+	}
+	pending.emplace( key, Pending{ move(callback), timer } );
+	return true;
+}
+
+bool ARPReactor::receive( ARPSocket &sock, ReceiveCallback callback )
+{
+	const int fd = sock.getEventHandle();
+	TimerId timer = 0;
+
+	if( !handles.count( fd ) ){
+		errno = EINVAL;
+		return false;
+	}
+
+	if( sock.getTimeout() ){
+		// El identificador que addTimer() asignará al temporizador
+		timer = nextTimer;
+		addTimer( sock.getTimeout(), [this, fd, timer]( void ){
+				auto &list = waiters[fd];
+				for( auto it = list.begin() ; it != list.end() ; ++it ){
+					if( it->timer != timer )
+						continue;
+					auto cb = move( it->callback );
+					list.erase( it );
+					if( cb )
+						cb( nullptr, nullptr );
+					return;
+				}
+			} );
+	}
+	waiters[fd].push_back( Waiter{ move(callback), timer } );
+	return true;
+}
+
+void ARPReactor::dispatch( int fd, const ARPFrame &frame, const HwAddr &sender )
+{
+	auto w = waiters.find( fd );
+	if( w != waiters.end() && !w->second.empty() ){
+		vector<Waiter> ready;
+		ready.swap( w->second );
+		for( auto &waiter : ready )
+			cancelTimer( waiter.timer );
+		for( auto &waiter : ready )
+			if( waiter.callback )
+				waiter.callback( &frame, &sender );
+	}
+
+	if( frame.getOpCode() != OperationCode::REPLY )
+		return;
+
+	const IPv4Addr ip = frame.getSourceIPAddr();
+	auto range = pending.equal_range( pendingKey( fd, ip.toNetworkInt() ) );
+	if( range.first == range.second )
+		return;
+
+	vector<ResolveCallback> callbacks;
+	for( auto it = range.first ; it != range.second ; ++it ){
+		cancelTimer( it->second.timer );
+		callbacks.push_back( move(it->second.callback) );
+	}
+	pending.erase( range.first, range.second );
+
+	const HwAddr hw = frame.getSourceHwAddr();
+	for( auto &cb : callbacks )
+		if( cb )
+			cb( ip, &hw );
+}
+
+size_t ARPReactor::expireTimers( void )
+{
+	const Clock::time_point now = Clock::now();
+	size_t count = 0;
+
+	while( !timers.empty() && timers.begin()->first.first <= now ){
+		auto it = timers.begin();
+		TimerHandler handler = move( it->second );
+		timerIndex.erase( it->first.second );
+		timers.erase( it );
+		if( handler )
+			handler();
+		count++;
+	}
+	return count;
+}
+
+int ARPReactor::getNextTimeout( void ) const
+{
+	if( timers.empty() )
+		return -1;
+
+	auto until = chrono::duration_cast<chrono::milliseconds>(
+			timers.begin()->first.first - Clock::now() ).count() + 1;
+	return until < 0 ? 0 : until;
+}
+
+size_t ARPReactor::runOnce( int msecs )
+{
+	struct epoll_event events[MaxEvents];
+	size_t count = 0;
+	int wait = msecs;
+	int until = getNextTimeout();
+
+	if( until >= 0 && ( wait < 0 || until < wait ) )
+		wait = until;
+
+	int n = epoll_wait( epfd, events, MaxEvents, wait );
+	if( n < 0 ){
+		if( errno != EINTR )
+			throw system_error( errno, generic_category(),
+					"ARPReactor::runOnce" );
+		n = 0;
+	}
+
+	for( int i = 0 ; i < n ; i++ ){
+		auto it = handles.find( events[i].data.fd );
+		if( it == handles.end() )
+			continue;
+		// Conserva la función aunque el manejador elimine su registro
+		auto handler = it->second;
+		(*handler)();
+		count++;
+	}
+	return count + expireTimers();
+}
+
+void ARPReactor::run( void )
+{
+	stopped = false;
+	while( !stopped && ( !handles.empty() || !timers.empty() ) )
+		runOnce();
+}
@@ -0,0 +1,95 @@
+#include <reroman/arp/arpreceivergroup.hpp>
+#include <stdexcept>
+#include <system_error>
+
+#include <cerrno>
+
+#include <pthread.h>
+#include <sched.h>
+
+using namespace std;
+using namespace reroman;
+using namespace reroman::arp;
+
+ARPReceiverGroup::ARPReceiverGroup( const NetworkInterface &nic,
+		unsigned int size, FanoutMode mode )
+	: running( false )
+{
+	uint16_t group = 0;
+
+	if( !size )
+		size = max( thread::hardware_concurrency(), 1U );
+
+	for( unsigned int i = 0 ; i < size ; i++ ){
+		unique_ptr<ARPSocket> sock( new ARPSocket() );
+
+		// El primer socket crea el grupo y el kernel le asigna el
+		// identificador
+		if( !sock->bind( nic ) || !( i ? sock->joinFanout( group, mode ) :
+					sock->createFanout( group, mode ) ) )
+			throw system_error( errno, generic_category(), "ARPReceiverGroup" );
+		// El anillo es opcional; sin él se utiliza recvfrom()
+		sock->enableRxRing();
+		sockets.push_back( move(sock) );
+	}
+}
+
+ARPReceiverGroup::~ARPReceiverGroup()
+{
+	running = false;
+	join();
+}
+
+void ARPReceiverGroup::start( const HandlerFactory &factory, bool pin )
+{
+	if( running )
+		throw logic_error( "ARPReceiverGroup is already running" );
+
+	const unsigned int cpus = max( thread::hardware_concurrency(), 1U );
+	error = nullptr;
+	running = true;
+
+	for( unsigned int i = 0 ; i < sockets.size() ; i++ ){
+		ARPSocket *sock = sockets[i].get();
+		ARPSocket::FrameHandler handler = factory( i );
+
+		threads.emplace_back( [this, sock, handler]( void ){
+				try{
+					while( running )
+						sock->receiveRing( handler );
+				}
+				catch( ... ){
+					lock_guard<mutex> lock( errorMutex );
+					if( !error )
+						error = current_exception();
+				}
+			} );
+
+		if( pin ){
+			cpu_set_t set;
+			CPU_ZERO( &set );
+			CPU_SET( i % cpus, &set );
+			pthread_setaffinity_np( threads.back().native_handle(),
+					sizeof(set), &set );
+		}
+	}
+}
+
+void ARPReceiverGroup::stop( void )
+{
+	running = false;
+	join();
+	if( error ){
+		exception_ptr e = error;
+		error = nullptr;
+		rethrow_exception( e );
+	}
+}
+
+void ARPReceiverGroup::join( void ) noexcept
+{
+	for( auto &t : threads )
+		if( t.joinable() )
+			t.join();
+	threads.clear();
+}
@@ -0,0 +1,472 @@
+#include <reroman/arp/arp.hpp>
+#include <system_error>
+#include <deque>
+#include <vector>
+#include <utility>
+
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+
+#if defined(__has_include)
+#	if __has_include(<linux/io_uring.h>)
+#		include <linux/io_uring.h>
+#	endif
+#endif
+
+using namespace std;
+using namespace reroman;
+using namespace reroman::arp;
+
+#if defined(IORING_RECV_MULTISHOT) && defined(__NR_io_uring_setup)
+
+namespace
+{
+	// Identifica la petición de recepción; los envíos usan el índice de su ranura
+	constexpr uint64_t RecvTag = ~0ULL;
+	constexpr uint16_t BufGroup = 0;
+	constexpr size_t BufSize = 128;
+
+	inline int uringSetup( unsigned int entries, io_uring_params *p )
+	{
+		return syscall( __NR_io_uring_setup, entries, p );
+	}
+
+	inline int uringEnter( int fd, unsigned int toSubmit,
+			unsigned int minComplete, unsigned int flags )
+	{
+		return syscall( __NR_io_uring_enter, fd, toSubmit, minComplete,
+				flags, nullptr, 0 );
+	}
+
+	inline int uringRegister( int fd, unsigned int op, void *arg,
+			unsigned int nargs )
+	{
+		return syscall( __NR_io_uring_register, fd, op, arg, nargs );
+	}
+}
+
+struct ARPSocket::Uring
+{
+	struct SendSlot
+	{
+		struct msghdr msg;
+		struct iovec iov;
+		struct sockaddr_ll sll;
+		ARPFrame frame;
+	};
+
+	int fd = -1;
+	int sock;
+
+	void *sqMem = MAP_FAILED;
+	size_t sqMemSize = 0;
+	void *cqMem = MAP_FAILED;
+	size_t cqMemSize = 0;
+	io_uring_sqe *sqes = static_cast<io_uring_sqe*>( MAP_FAILED );
+	size_t sqesSize = 0;
+
+	unsigned int *sqHead;
+	unsigned int *sqTail;
+	unsigned int *sqFlags;
+	unsigned int sqMask;
+	unsigned int sqEntries;
+	unsigned int sqLocalTail;
+	unsigned int toSubmit = 0;
+
+	unsigned int *cqHead;
+	unsigned int *cqTail;
+	unsigned int cqMask;
+	io_uring_cqe *cqes;
+
+	io_uring_buf_ring *bufRing = static_cast<io_uring_buf_ring*>( MAP_FAILED );
+	size_t bufRingSize = 0;
+	vector<uint8_t> buffers;
+	unsigned int bufCount;
+	uint16_t bufTail = 0;
+	struct msghdr recvMsg;
+
+	vector<SendSlot> slots;
+	vector<uint32_t> freeSlots;
+	deque<pair<ARPFrame, sockaddr_ll>> stash;
+
+	explicit Uring( int sock ) : sock( sock ){}
+	~Uring();
+
+	bool open( unsigned int entries );
+	io_uring_sqe* getSqe( void );
+	void submit( unsigned int wait = 0 );
+	void armRecv( void );
+	void recycle( uint16_t bid ) noexcept;
+	bool handle( const io_uring_cqe &cqe, ARPFrame &frame, sockaddr_ll &sll );
+	bool next( ARPFrame &frame, sockaddr_ll &sll );
+	void reapSends( void );
+};
+
+ARPSocket::Uring::~Uring()
+{
+	if( fd >= 0 )
+		close( fd );
+	if( bufRing != MAP_FAILED )
+		munmap( bufRing, bufRingSize );
+	if( sqes != MAP_FAILED )
+		munmap( sqes, sqesSize );
+	if( cqMem != MAP_FAILED && cqMem != sqMem )
+		munmap( cqMem, cqMemSize );
+	if( sqMem != MAP_FAILED )
+		munmap( sqMem, sqMemSize );
+}
+
+bool ARPSocket::Uring::open( unsigned int entries )
+{
+	io_uring_params params;
+
+	// La cola de terminación debe dar cabida a los envíos en vuelo y a
+	// las tramas recibidas entre cada lectura
+	memset( &params, 0, sizeof(params) );
+	params.flags = IORING_SETUP_CQSIZE;
+	params.cq_entries = max( entries, 1U ) * 8;
+	if( (fd = uringSetup( entries, &params )) < 0 )
+		return false;
+
+	sqMemSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+	cqMemSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	if( params.features & IORING_FEAT_SINGLE_MMAP )
+		sqMemSize = cqMemSize = max( sqMemSize, cqMemSize );
+
+	sqMem = mmap( nullptr, sqMemSize, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING );
+	if( sqMem == MAP_FAILED )
+		return false;
+	if( params.features & IORING_FEAT_SINGLE_MMAP )
+		cqMem = sqMem;
+	else{
+		cqMem = mmap( nullptr, cqMemSize, PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING );
+		if( cqMem == MAP_FAILED )
+			return false;
+	}
+	sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	void *mem = mmap( nullptr, sqesSize, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES );
+	if( mem == MAP_FAILED )
+		return false;
+	sqes = static_cast<io_uring_sqe*>( mem );
+
+	uint8_t *sq = static_cast<uint8_t*>( sqMem );
+	uint8_t *cq = static_cast<uint8_t*>( cqMem );
+	sqHead = reinterpret_cast<unsigned int*>( sq + params.sq_off.head );
+	sqTail = reinterpret_cast<unsigned int*>( sq + params.sq_off.tail );
+	sqFlags = reinterpret_cast<unsigned int*>( sq + params.sq_off.flags );
+	sqMask = *reinterpret_cast<unsigned int*>( sq + params.sq_off.ring_mask );
+	sqEntries = params.sq_entries;
+	sqLocalTail = *sqTail;
+	cqHead = reinterpret_cast<unsigned int*>( cq + params.cq_off.head );
+	cqTail = reinterpret_cast<unsigned int*>( cq + params.cq_off.tail );
+	cqMask = *reinterpret_cast<unsigned int*>( cq + params.cq_off.ring_mask );
+	cqes = reinterpret_cast<io_uring_cqe*>( cq + params.cq_off.cqes );
+
+	// Cada entrada de la cola de envío apunta a la SQE con el mismo índice
+	unsigned int *array = reinterpret_cast<unsigned int*>(
+			sq + params.sq_off.array );
+	for( unsigned int i = 0 ; i < sqEntries ; i++ )
+		array[i] = i;
+
+	// Anillo de buffers provistos para la recepción de disparo múltiple
+	bufCount = min( sqEntries * 4, 32768U );
+	bufRingSize = bufCount * sizeof(io_uring_buf);
+	mem = mmap( nullptr, bufRingSize, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0 );
+	if( mem == MAP_FAILED )
+		return false;
+	bufRing = static_cast<io_uring_buf_ring*>( mem );
+	buffers.resize( bufCount * BufSize );
+
+	io_uring_buf_reg reg;
+	memset( &reg, 0, sizeof(reg) );
+	reg.ring_addr = reinterpret_cast<uint64_t>( bufRing );
+	reg.ring_entries = bufCount;
+	reg.bgid = BufGroup;
+	if( uringRegister( fd, IORING_REGISTER_PBUF_RING, &reg, 1 ) < 0 )
+		return false;
+	for( unsigned int i = 0 ; i < bufCount ; i++ )
+		recycle( i );
+
+	slots.resize( sqEntries * 2 );
+	for( uint32_t i = slots.size() ; i > 0 ; i-- ){
+		SendSlot &slot = slots[i - 1];
+		memset( &slot.msg, 0, sizeof(slot.msg) );
+		slot.iov.iov_base = &slot.frame;
+		slot.iov.iov_len = sizeof(ARPFrame);
+		slot.msg.msg_name = &slot.sll;
+		slot.msg.msg_namelen = sizeof(slot.sll);
+		slot.msg.msg_iov = &slot.iov;
+		slot.msg.msg_iovlen = 1;
+		freeSlots.push_back( i - 1 );
+	}
+
+	memset( &recvMsg, 0, sizeof(recvMsg) );
+	recvMsg.msg_namelen = sizeof(sockaddr_ll);
+	armRecv();
+	try{
+		submit();
+	}
+	catch( system_error &e ){
+		errno = e.code().value();
+		return false;
+	}
+	return true;
+}
+
+io_uring_sqe* ARPSocket::Uring::getSqe( void )
+{
+	if( sqLocalTail - __atomic_load_n( sqHead, __ATOMIC_ACQUIRE ) >= sqEntries )
+		submit();
+
+	io_uring_sqe *sqe = &sqes[sqLocalTail & sqMask];
+	memset( sqe, 0, sizeof(*sqe) );
+	sqLocalTail++;
+	toSubmit++;
+	return sqe;
+}
+
+void ARPSocket::Uring::submit( unsigned int wait )
+{
+	__atomic_store_n( sqTail, sqLocalTail, __ATOMIC_RELEASE );
+	while( toSubmit || wait ){
+		int res = uringEnter( fd, toSubmit, wait,
+				wait ? IORING_ENTER_GETEVENTS : 0 );
+		if( res < 0 ){
+			if( errno == EINTR )
+				continue;
+			throw system_error( errno, generic_category(), "io_uring_enter" );
+		}
+		// El kernel no consumió ninguna petición; reintentar no avanzaría
+		if( !res && toSubmit )
+			throw system_error( EBUSY, generic_category(), "io_uring_enter" );
+		toSubmit -= res;
+		wait = 0;
+	}
+}
+
+void ARPSocket::Uring::armRecv( void )
+{
+	io_uring_sqe *sqe = getSqe();
+
+	sqe->opcode = IORING_OP_RECVMSG;
+	sqe->fd = sock;
+	sqe->addr = reinterpret_cast<uint64_t>( &recvMsg );
+	sqe->len = 1;
+	sqe->ioprio = IORING_RECV_MULTISHOT;
+	sqe->flags = IOSQE_BUFFER_SELECT;
+	sqe->buf_group = BufGroup;
+	sqe->user_data = RecvTag;
+}
+
+void ARPSocket::Uring::recycle( uint16_t bid ) noexcept
+{
+	// En C++ el miembro bufs del encabezado queda desplazado por la
+	// estructura vacía de __DECLARE_FLEX_ARRAY, por lo que se indexa a mano
+	io_uring_buf *buf = reinterpret_cast<io_uring_buf*>( bufRing ) +
+		( bufTail & ( bufCount - 1 ) );
+
+	buf->addr = reinterpret_cast<uint64_t>( buffers.data() + bid * BufSize );
+	buf->len = BufSize;
+	buf->bid = bid;
+	bufTail++;
+	__atomic_store_n( &bufRing->tail, bufTail, __ATOMIC_RELEASE );
+}
+
+bool ARPSocket::Uring::handle( const io_uring_cqe &cqe, ARPFrame &frame,
+		sockaddr_ll &sll )
+{
+	if( cqe.user_data != RecvTag ){
+		freeSlots.push_back( static_cast<uint32_t>( cqe.user_data ) );
+		return false;
+	}
+
+	bool valid = false;
+	if( cqe.flags & IORING_CQE_F_BUFFER ){
+		const uint16_t bid = cqe.flags >> IORING_CQE_BUFFER_SHIFT;
+		const uint8_t *buf = buffers.data() + bid * BufSize;
+		auto out = reinterpret_cast<const io_uring_recvmsg_out*>( buf );
+		const size_t header = sizeof(*out) + recvMsg.msg_namelen +
+			recvMsg.msg_controllen;
+
+		if( cqe.res >= 0 && static_cast<size_t>(cqe.res) >= header &&
+				EthernetARPFrameView( buf + header, min<size_t>(
+						out->payloadlen, cqe.res - header ) ) ){
+			memset( &sll, 0, sizeof(sll) );
+			memcpy( &sll, buf + sizeof(*out),
+					min<size_t>( out->namelen, sizeof(sll) ) );
+			memcpy( &frame, buf + header, sizeof(ARPFrame) );
+			valid = true;
+		}
+		recycle( bid );
+	}
+	else if( cqe.res < 0 && cqe.res != -ENOBUFS )
+		throw system_error( -cqe.res, generic_category(), "io_uring recvmsg" );
+
+	// La petición de disparo múltiple terminó y debe volver a enviarse
+	if( !(cqe.flags & IORING_CQE_F_MORE) ){
+		armRecv();
+		submit();
+	}
+	return valid;
+}
+
+bool ARPSocket::Uring::next( ARPFrame &frame, sockaddr_ll &sll )
+{
+	if( !stash.empty() ){
+		frame = stash.front().first;
+		sll = stash.front().second;
+		stash.pop_front();
+		return true;
+	}
+
+	unsigned int head = *cqHead;
+	while( true ){
+		if( head == __atomic_load_n( cqTail, __ATOMIC_ACQUIRE ) ){
+			// Las terminaciones que no cupieron esperan en el kernel
+			if( !(__atomic_load_n( sqFlags, __ATOMIC_ACQUIRE ) &
+						IORING_SQ_CQ_OVERFLOW) )
+				return false;
+			if( uringEnter( fd, 0, 0, IORING_ENTER_GETEVENTS ) < 0 &&
+					errno != EINTR )
+				throw system_error( errno, generic_category(),
+						"io_uring_enter" );
+			continue;
+		}
+		const io_uring_cqe cqe = cqes[head & cqMask];
+		__atomic_store_n( cqHead, ++head, __ATOMIC_RELEASE );
+		if( handle( cqe, frame, sll ) )
+			return true;
+	}
+}
+
+void ARPSocket::Uring::reapSends( void )
+{
+	ARPFrame frame;
+	sockaddr_ll sll;
+
+	if( freeSlots.empty() )
+		submit( 1 );
+
+	unsigned int head = *cqHead;
+	while( head != __atomic_load_n( cqTail, __ATOMIC_ACQUIRE ) ){
+		const io_uring_cqe cqe = cqes[head & cqMask];
+		__atomic_store_n( cqHead, ++head, __ATOMIC_RELEASE );
+		if( handle( cqe, frame, sll ) )
+			stash.emplace_back( frame, sll );
+	}
+}
+
+bool ARPSocket::enableUring( unsigned int entries )
+{
+	if( ring || uring ){
+		errno = EBUSY;
+		return false;
+	}
+
+	Uring *u = new Uring( sock );
+	if( !u->open( entries ) ){
+		int err = errno;
+		delete u;
+		errno = err;
+		return false;
+	}
+	uring = u;
+	return true;
+}
+
+void ARPSocket::disableUring( void ) noexcept
+{
+	delete uring;
+	uring = nullptr;
+}
+
+int ARPSocket::getEventHandle( void ) const noexcept
+{
+	return uring ? uring->fd : sock;
+}
+
+bool ARPSocket::uringNext( ARPFrame &frame, struct sockaddr_ll &sll )
+{
+	return uring->next( frame, sll );
+}
+
+size_t ARPSocket::uringSend( const ARPFrame *frames, size_t count,
+		const HwAddr &dst, const NetworkInterface &nic )
+{
+	const int index = nic.getIndex();
+
+	for( size_t i = 0 ; i < count ; i++ ){
+		while( uring->freeSlots.empty() )
+			uring->reapSends();
+
+		const uint32_t id = uring->freeSlots.back();
+		Uring::SendSlot &slot = uring->slots[id];
+		uring->freeSlots.pop_back();
+
+		slot.frame = frames[i];
+		memset( &slot.sll, 0, sizeof(slot.sll) );
+		slot.sll.sll_family = AF_PACKET;
+		slot.sll.sll_protocol = htons( ETH_P_ARP );
+		slot.sll.sll_ifindex = index;
+		slot.sll.sll_halen = HwAddr::HwAddrLen;
+		dst.copyTo( slot.sll.sll_addr );
+
+		io_uring_sqe *sqe = uring->getSqe();
+		sqe->opcode = IORING_OP_SENDMSG;
+		sqe->fd = sock;
+		sqe->addr = reinterpret_cast<uint64_t>( &slot.msg );
+		sqe->len = 1;
+		sqe->user_data = id;
+	}
+	uring->submit();
+	return count;
+}
+
+#else // Sin soporte para io_uring
+
+struct ARPSocket::Uring
+{
+	int fd;
+};
+
+bool ARPSocket::enableUring( unsigned int )
+{
+	errno = ENOSYS;
+	return false;
+}
+
+void ARPSocket::disableUring( void ) noexcept
+{
+	delete uring;
+	uring = nullptr;
+}
+
+int ARPSocket::getEventHandle( void ) const noexcept
+{
+	return uring ? uring->fd : sock;
+}
+
+bool ARPSocket::uringNext( ARPFrame&, struct sockaddr_ll& )
+{
+	return false;
+}
+
+size_t ARPSocket::uringSend( const ARPFrame*, size_t, const HwAddr&,
+		const NetworkInterface& )
+{
+	return 0;
+}
+
+#endif
@@ -1,9 +1,7 @@
 #include <reroman/hwaddr.hpp>
-#include <sstream>
-#include <vector>
 #include <stdexcept>
+#include <type_traits>
 #include <system_error>
-#include <boost/algorithm/string/split.hpp>
 
 #include <cstring>
 #include <cerrno>
@@ -17,9 +15,63 @@
 using namespace std;
 using namespace reroman;
 
-HwAddr::HwAddr( void ) noexcept
+static_assert( is_trivially_copyable<HwAddr>::value,
+		"HwAddr must be trivially copyable" );
+
+namespace
 {
-	clear();
+	const char Digits[] = "0123456789abcdef";
+
+	// Valor de cada carácter como dígito hexadecimal, -1 si no lo es
+	const int8_t HexValue[256] = {
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+		-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+	};
+
+	inline int hexValue( const char *p, const char *end )
+	{
+		return p < end ? HexValue[static_cast<uint8_t>( *p )] : -1;
+	}
+
+	/*
+	 * Lee de minDigits a maxDigits dígitos hexadecimales. Regresa falso si
+	 * hay menos de minDigits o si después de maxDigits sigue otro dígito.
+	 */
+	bool parseGroup( const char *&p, const char *end, int minDigits,
+			int maxDigits, uint32_t &value )
+	{
+		int digits = 0;
+		int v;
+
+		value = 0;
+		while( ( v = hexValue( p, end ) ) >= 0 ){
+			if( ++digits > maxDigits )
+				return false;
+			value = ( value << 4 ) | v;
+			p++;
+		}
+		return digits >= minDigits;
+	}
+
+	inline bool isDelimiter( char c )
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',' ||
+			c == ';';
+	}
 }
 
 HwAddr::HwAddr( string addr )
@@ -42,56 +94,85 @@ HwAddr::HwAddr( const uint8_t *bytes )
 	setData( bytes );
 }
 
-HwAddr::HwAddr( const HwAddr &addr ) noexcept
+string HwAddr::toString( void ) const
 {
-	for( int i = 0 ; i < HwAddrLen ; i++ )
-		data[i] = addr.data[i];
-}
+	char buffer[MaxStringLen];
 
-bool HwAddr::isNull( void ) const noexcept
-{
-	for( auto &i : data )
-		if( i )
-			return false;
-	return true;
+	return string( buffer, toChars( buffer ) );
 }
 
-string HwAddr::toString( void ) const
+char* HwAddr::toChars( char *buffer, HwAddrFormat format ) const noexcept
 {
-	ostringstream out;
-
-	out << hex;
-	for( int i = 0 ; i < HwAddrLen ; ){
-		out.fill( '0' );
-		out.width( 2 );
-		out << static_cast<int>( data[i] );
-		if( ++i != HwAddrLen )
-			out << ':';
+	const char separator = format == HwAddrFormat::DASH ? '-' : ':';
+
+	for( int i = 0 ; i < HwAddrLen ; i++ ){
+		*buffer++ = Digits[data[i] >> 4];
+		*buffer++ = Digits[data[i] & 0x0f];
+
+		if( i == HwAddrLen - 1 )
+			break;
+		if( format == HwAddrFormat::COLON || format == HwAddrFormat::DASH )
+			*buffer++ = separator;
+		else if( format == HwAddrFormat::CISCO && i % 2 )
+			*buffer++ = '.';
 	}
-	return out.str();
+	return buffer;
 }
 
-void HwAddr::setData( string addr )
+void HwAddr::setData( const string &addr )
 {
-	string::size_type noNum;
-	string errorMessage = addr + " is not a valid MAC address";
-	vector<string> toks;
-	boost::split( toks, addr, [](char c){ return c == ':'; } );
+	CharsResult result = fromChars( addr.data(), addr.size() );
 
-	if( toks.size() != HwAddrLen )
-		throw invalid_argument( errorMessage );
+	if( result.ec != errc() || result.ptr != addr.data() + addr.size() )
+		throw invalid_argument( addr + " is not a valid MAC address" );
+}
 
-	try{
-		for( int i = 0 ; i < HwAddrLen ; i++ ){
-			int aux = stoi( toks[i], &noNum, 16 );
-			if( noNum < toks[i].size() || aux > 0xff )
-				throw invalid_argument( errorMessage );
-			data[i] = static_cast<uint8_t>( aux );
+CharsResult HwAddr::fromChars( const char *text, size_t len ) noexcept
+{
+	const char *end = text + len;
+	const char *p = text;
+	const CharsResult invalid{ text, errc::invalid_argument };
+	uint8_t bytes[HwAddrLen];
+	uint32_t value;
+
+	int digits = 0;
+	while( hexValue( text + digits, end ) >= 0 && digits <= 2 * HwAddrLen )
+		digits++;
+
+	if( digits == 2 * HwAddrLen ){
+		// xxxxxxxxxxxx
+		for( int i = 0 ; i < HwAddrLen ; i++, p += 2 )
+			bytes[i] = HexValue[static_cast<uint8_t>( p[0] )] << 4 |
+				HexValue[static_cast<uint8_t>( p[1] )];
+	}
+	else if( digits == 4 && p + 4 < end && p[4] == '.' ){
+		// xxxx.xxxx.xxxx
+		for( int i = 0 ; i < HwAddrLen ; i += 2 ){
+			if( i && ( p >= end || *p++ != '.' ) )
+				return invalid;
+			if( !parseGroup( p, end, 4, 4, value ) )
+				return invalid;
+			bytes[i] = value >> 8;
+			bytes[i + 1] = value & 0xff;
 		}
 	}
-	catch( out_of_range ){
-		throw invalid_argument( errorMessage );
+	else if( ( digits == 1 || digits == 2 ) && p + digits < end &&
+			( p[digits] == ':' || p[digits] == '-' ) ){
+		// xx:xx:xx:xx:xx:xx o xx-xx-xx-xx-xx-xx
+		const char separator = p[digits];
+		for( int i = 0 ; i < HwAddrLen ; i++ ){
+			if( i && ( p >= end || *p++ != separator ) )
+				return invalid;
+			if( !parseGroup( p, end, 1, 2, value ) )
+				return invalid;
+			bytes[i] = value;
+		}
 	}
+	else
+		return invalid;
+
+	setData( bytes );
+	return CharsResult{ p, errc() };
 }
 
 void HwAddr::setData( initializer_list<uint8_t> bytes )
@@ -106,6 +187,48 @@ void HwAddr::setData( initializer_list<uint8_t> bytes )
 	}
 }
 
+size_t HwAddr::toChars( const HwAddr *addrs, size_t count, char *buffer,
+		char separator, HwAddrFormat format ) noexcept
+{
+	char *p = buffer;
+
+	for( size_t i = 0 ; i < count ; i++ ){
+		p = addrs[i].toChars( p, format );
+		*p++ = separator;
+	}
+	return p - buffer;
+}
+
+size_t HwAddr::fromChars( const char *text, size_t len, HwAddr *addrs,
+		size_t max, CharsResult *result ) noexcept
+{
+	const char *end = text + len;
+	const char *p = text;
+	size_t count = 0;
+	CharsResult last{ p, errc() };
+
+	while( count < max ){
+		while( p < end && isDelimiter( *p ) )
+			p++;
+		if( p == end )
+			break;
+
+		last = addrs[count].fromChars( p, end - p );
+		if( last.ec == errc() && last.ptr < end && !isDelimiter( *last.ptr ) )
+			last = CharsResult{ p, errc::invalid_argument };
+		if( last.ec != errc() )
+			break;
+		p = last.ptr;
+		count++;
+	}
+
+	if( result ){
+		result->ptr = last.ec == errc() ? p : last.ptr;
+		result->ec = last.ec;
+	}
+	return count;
+}
+
 HwAddr HwAddr::getFromInterface( string ifname )
 {
 	int sockfd;
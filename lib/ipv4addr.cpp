@@ -1,5 +1,6 @@
 #include <reroman/ipv4addr.hpp>
 #include <stdexcept>
+#include <type_traits>
 #include <system_error>
 
 #include <cerrno>
@@ -14,45 +15,168 @@
 using namespace std;
 using namespace reroman;
 
-IPv4Addr::IPv4Addr( uint32_t addr ) noexcept
-: data( {addr} ){}
+static_assert( is_trivially_copyable<IPv4Addr>::value,
+		"IPv4Addr must be trivially copyable" );
+
+namespace
+{
+	// Texto de cada número de 0 a 255, precedido por su longitud
+	const char Octets[256][4] = {
+		{ 1, '0' }, { 1, '1' }, { 1, '2' }, { 1, '3' }, { 1, '4' }, { 1, '5' }, { 1, '6' }, { 1, '7' },
+		{ 1, '8' }, { 1, '9' }, { 2, '1', '0' }, { 2, '1', '1' }, { 2, '1', '2' }, { 2, '1', '3' }, { 2, '1', '4' }, { 2, '1', '5' },
+		{ 2, '1', '6' }, { 2, '1', '7' }, { 2, '1', '8' }, { 2, '1', '9' }, { 2, '2', '0' }, { 2, '2', '1' }, { 2, '2', '2' }, { 2, '2', '3' },
+		{ 2, '2', '4' }, { 2, '2', '5' }, { 2, '2', '6' }, { 2, '2', '7' }, { 2, '2', '8' }, { 2, '2', '9' }, { 2, '3', '0' }, { 2, '3', '1' },
+		{ 2, '3', '2' }, { 2, '3', '3' }, { 2, '3', '4' }, { 2, '3', '5' }, { 2, '3', '6' }, { 2, '3', '7' }, { 2, '3', '8' }, { 2, '3', '9' },
+		{ 2, '4', '0' }, { 2, '4', '1' }, { 2, '4', '2' }, { 2, '4', '3' }, { 2, '4', '4' }, { 2, '4', '5' }, { 2, '4', '6' }, { 2, '4', '7' },
+		{ 2, '4', '8' }, { 2, '4', '9' }, { 2, '5', '0' }, { 2, '5', '1' }, { 2, '5', '2' }, { 2, '5', '3' }, { 2, '5', '4' }, { 2, '5', '5' },
+		{ 2, '5', '6' }, { 2, '5', '7' }, { 2, '5', '8' }, { 2, '5', '9' }, { 2, '6', '0' }, { 2, '6', '1' }, { 2, '6', '2' }, { 2, '6', '3' },
+		{ 2, '6', '4' }, { 2, '6', '5' }, { 2, '6', '6' }, { 2, '6', '7' }, { 2, '6', '8' }, { 2, '6', '9' }, { 2, '7', '0' }, { 2, '7', '1' },
+		{ 2, '7', '2' }, { 2, '7', '3' }, { 2, '7', '4' }, { 2, '7', '5' }, { 2, '7', '6' }, { 2, '7', '7' }, { 2, '7', '8' }, { 2, '7', '9' },
+		{ 2, '8', '0' }, { 2, '8', '1' }, { 2, '8', '2' }, { 2, '8', '3' }, { 2, '8', '4' }, { 2, '8', '5' }, { 2, '8', '6' }, { 2, '8', '7' },
+		{ 2, '8', '8' }, { 2, '8', '9' }, { 2, '9', '0' }, { 2, '9', '1' }, { 2, '9', '2' }, { 2, '9', '3' }, { 2, '9', '4' }, { 2, '9', '5' },
+		{ 2, '9', '6' }, { 2, '9', '7' }, { 2, '9', '8' }, { 2, '9', '9' }, { 3, '1', '0', '0' }, { 3, '1', '0', '1' }, { 3, '1', '0', '2' }, { 3, '1', '0', '3' },
+		{ 3, '1', '0', '4' }, { 3, '1', '0', '5' }, { 3, '1', '0', '6' }, { 3, '1', '0', '7' }, { 3, '1', '0', '8' }, { 3, '1', '0', '9' }, { 3, '1', '1', '0' }, { 3, '1', '1', '1' },
+		{ 3, '1', '1', '2' }, { 3, '1', '1', '3' }, { 3, '1', '1', '4' }, { 3, '1', '1', '5' }, { 3, '1', '1', '6' }, { 3, '1', '1', '7' }, { 3, '1', '1', '8' }, { 3, '1', '1', '9' },
+		{ 3, '1', '2', '0' }, { 3, '1', '2', '1' }, { 3, '1', '2', '2' }, { 3, '1', '2', '3' }, { 3, '1', '2', '4' }, { 3, '1', '2', '5' }, { 3, '1', '2', '6' }, { 3, '1', '2', '7' },
+		{ 3, '1', '2', '8' }, { 3, '1', '2', '9' }, { 3, '1', '3', '0' }, { 3, '1', '3', '1' }, { 3, '1', '3', '2' }, { 3, '1', '3', '3' }, { 3, '1', '3', '4' }, { 3, '1', '3', '5' },
+		{ 3, '1', '3', '6' }, { 3, '1', '3', '7' }, { 3, '1', '3', '8' }, { 3, '1', '3', '9' }, { 3, '1', '4', '0' }, { 3, '1', '4', '1' }, { 3, '1', '4', '2' }, { 3, '1', '4', '3' },
+		{ 3, '1', '4', '4' }, { 3, '1', '4', '5' }, { 3, '1', '4', '6' }, { 3, '1', '4', '7' }, { 3, '1', '4', '8' }, { 3, '1', '4', '9' }, { 3, '1', '5', '0' }, { 3, '1', '5', '1' },
+		{ 3, '1', '5', '2' }, { 3, '1', '5', '3' }, { 3, '1', '5', '4' }, { 3, '1', '5', '5' }, { 3, '1', '5', '6' }, { 3, '1', '5', '7' }, { 3, '1', '5', '8' }, { 3, '1', '5', '9' },
+		{ 3, '1', '6', '0' }, { 3, '1', '6', '1' }, { 3, '1', '6', '2' }, { 3, '1', '6', '3' }, { 3, '1', '6', '4' }, { 3, '1', '6', '5' }, { 3, '1', '6', '6' }, { 3, '1', '6', '7' },
+		{ 3, '1', '6', '8' }, { 3, '1', '6', '9' }, { 3, '1', '7', '0' }, { 3, '1', '7', '1' }, { 3, '1', '7', '2' }, { 3, '1', '7', '3' }, { 3, '1', '7', '4' }, { 3, '1', '7', '5' },
+		{ 3, '1', '7', '6' }, { 3, '1', '7', '7' }, { 3, '1', '7', '8' }, { 3, '1', '7', '9' }, { 3, '1', '8', '0' }, { 3, '1', '8', '1' }, { 3, '1', '8', '2' }, { 3, '1', '8', '3' },
+		{ 3, '1', '8', '4' }, { 3, '1', '8', '5' }, { 3, '1', '8', '6' }, { 3, '1', '8', '7' }, { 3, '1', '8', '8' }, { 3, '1', '8', '9' }, { 3, '1', '9', '0' }, { 3, '1', '9', '1' },
+		{ 3, '1', '9', '2' }, { 3, '1', '9', '3' }, { 3, '1', '9', '4' }, { 3, '1', '9', '5' }, { 3, '1', '9', '6' }, { 3, '1', '9', '7' }, { 3, '1', '9', '8' }, { 3, '1', '9', '9' },
+		{ 3, '2', '0', '0' }, { 3, '2', '0', '1' }, { 3, '2', '0', '2' }, { 3, '2', '0', '3' }, { 3, '2', '0', '4' }, { 3, '2', '0', '5' }, { 3, '2', '0', '6' }, { 3, '2', '0', '7' },
+		{ 3, '2', '0', '8' }, { 3, '2', '0', '9' }, { 3, '2', '1', '0' }, { 3, '2', '1', '1' }, { 3, '2', '1', '2' }, { 3, '2', '1', '3' }, { 3, '2', '1', '4' }, { 3, '2', '1', '5' },
+		{ 3, '2', '1', '6' }, { 3, '2', '1', '7' }, { 3, '2', '1', '8' }, { 3, '2', '1', '9' }, { 3, '2', '2', '0' }, { 3, '2', '2', '1' }, { 3, '2', '2', '2' }, { 3, '2', '2', '3' },
+		{ 3, '2', '2', '4' }, { 3, '2', '2', '5' }, { 3, '2', '2', '6' }, { 3, '2', '2', '7' }, { 3, '2', '2', '8' }, { 3, '2', '2', '9' }, { 3, '2', '3', '0' }, { 3, '2', '3', '1' },
+		{ 3, '2', '3', '2' }, { 3, '2', '3', '3' }, { 3, '2', '3', '4' }, { 3, '2', '3', '5' }, { 3, '2', '3', '6' }, { 3, '2', '3', '7' }, { 3, '2', '3', '8' }, { 3, '2', '3', '9' },
+		{ 3, '2', '4', '0' }, { 3, '2', '4', '1' }, { 3, '2', '4', '2' }, { 3, '2', '4', '3' }, { 3, '2', '4', '4' }, { 3, '2', '4', '5' }, { 3, '2', '4', '6' }, { 3, '2', '4', '7' },
+		{ 3, '2', '4', '8' }, { 3, '2', '4', '9' }, { 3, '2', '5', '0' }, { 3, '2', '5', '1' }, { 3, '2', '5', '2' }, { 3, '2', '5', '3' }, { 3, '2', '5', '4' }, { 3, '2', '5', '5' }
+	};
+
+	inline bool isDigit( const char *p, const char *end )
+	{
+		return p < end && static_cast<unsigned char>( *p - '0' ) < 10;
+	}
+
+	inline bool isDelimiter( char c )
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',' ||
+			c == ';';
+	}
+}
 
 IPv4Addr::IPv4Addr( string addr )
 {
 	setAddr( addr );
 }
 
-IPv4Addr::IPv4Addr( struct in_addr addr ) noexcept
-: data( addr ){}
-
-IPv4Addr::IPv4Addr( const IPv4Addr &addr ) noexcept
-: data( addr.data ){}
-
 string IPv4Addr::toString( void ) const
 {
-	char tmp[INET_ADDRSTRLEN];
+	char buffer[MaxStringLen];
 
-	inet_ntop( AF_INET, &data, tmp, INET_ADDRSTRLEN );
-	return string( tmp );
+	return string( buffer, toChars( buffer ) );
 }
 
-bool IPv4Addr::isValidNetmask( void ) const noexcept
+char* IPv4Addr::toChars( char *buffer ) const noexcept
 {
-	uint32_t a = ntohl( data.s_addr );
+	const uint8_t *bytes = reinterpret_cast<const uint8_t*>( &data.s_addr );
+
+	for( int i = 0 ; i < IPv4AddrLen ; i++ ){
+		const char *octet = Octets[bytes[i]];
 
-	if( !a || (a & 0xff) >= 254 )
-		return false;
-	a = ~a;
-	uint32_t b = a + 1;
-	return !( b & a );
+		if( i )
+			*buffer++ = '.';
+		for( int j = 1 ; j <= octet[0] ; j++ )
+			*buffer++ = octet[j];
+	}
+	return buffer;
 }
 
-void IPv4Addr::setAddr( string addr )
+void IPv4Addr::setAddr( const string &addr )
 {
+	CharsResult result = fromChars( addr.data(), addr.size() );
+
+	if( result.ec == errc() && result.ptr == addr.data() + addr.size() )
+		return;
 	if( !inet_aton( addr.c_str(), &data ) )
 		throw invalid_argument( addr + " is not a valid IPv4 address" );
 }
 
+CharsResult IPv4Addr::fromChars( const char *text, size_t len ) noexcept
+{
+	const char *end = text + len;
+	const char *p = text;
+	uint32_t addr = 0;
+
+	for( int i = 0 ; i < IPv4AddrLen ; i++ ){
+		if( i ){
+			if( p >= end || *p != '.' )
+				return CharsResult{ text, errc::invalid_argument };
+			p++;
+		}
+		if( !isDigit( p, end ) )
+			return CharsResult{ text, errc::invalid_argument };
+
+		unsigned int octet = *p++ - '0';
+		for( int j = 1 ; j < 3 && octet && isDigit( p, end ) ; j++ )
+			octet = octet * 10 + ( *p++ - '0' );
+		// Ceros a la izquierda o más de tres dígitos
+		if( isDigit( p, end ) )
+			return CharsResult{ text, errc::invalid_argument };
+		if( octet > 255 )
+			return CharsResult{ text, errc::result_out_of_range };
+		addr = addr << 8 | octet;
+	}
+
+	data.s_addr = htonl( addr );
+	return CharsResult{ p, errc() };
+}
+
+size_t IPv4Addr::toChars( const IPv4Addr *addrs, size_t count, char *buffer,
+		char separator ) noexcept
+{
+	char *p = buffer;
+
+	for( size_t i = 0 ; i < count ; i++ ){
+		p = addrs[i].toChars( p );
+		*p++ = separator;
+	}
+	return p - buffer;
+}
+
+size_t IPv4Addr::fromChars( const char *text, size_t len, IPv4Addr *addrs,
+		size_t max, CharsResult *result ) noexcept
+{
+	const char *end = text + len;
+	const char *p = text;
+	size_t count = 0;
+	CharsResult last{ p, errc() };
+
+	while( count < max ){
+		while( p < end && isDelimiter( *p ) )
+			p++;
+		if( p == end )
+			break;
+
+		last = addrs[count].fromChars( p, end - p );
+		if( last.ec == errc() && last.ptr < end && !isDelimiter( *last.ptr ) )
+			last = CharsResult{ p, errc::invalid_argument };
+		if( last.ec != errc() )
+			break;
+		p = last.ptr;
+		count++;
+	}
+
+	if( result ){
+		result->ptr = last.ec == errc() ? p : last.ptr;
+		result->ec = last.ec;
+	}
+	return count;
+}
+
 IPv4Addr IPv4Addr::operator+( int n ) const
 {
 	int64_t tmp = ntohl( data.s_addr );
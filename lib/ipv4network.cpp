@@ -0,0 +1,84 @@
+#include <reroman/ipv4network.hpp>
+#include <stdexcept>
+
+using namespace std;
+using namespace reroman;
+
+IPv4Network::IPv4Network( const IPv4Addr &addr, const IPv4Addr &netmask )
+{
+	const uint32_t bits = netmask.toHostInt();
+
+	// Una máscara contigua, al negarse, es de la forma 0...01...1
+	if( ( ~bits + 1 ) & ~bits )
+		throw invalid_argument( netmask.toString() + " is not a valid netmask" );
+
+	prefix = 0;
+	for( uint32_t b = bits ; b ; b <<= 1 )
+		prefix++;
+	network = addr.toHostInt() & bits;
+}
+
+IPv4Network::IPv4Network( const string &cidr )
+{
+	const char *p = cidr.data();
+	const char *end = p + cidr.size();
+	IPv4Addr addr;
+	unsigned int length = 32;
+
+	CharsResult result = addr.fromChars( p, cidr.size() );
+	p = result.ptr;
+	if( result.ec == errc() && p < end && *p == '/' ){
+		p++;
+		result = prefixFromChars( p, end - p, length );
+		p = result.ptr;
+	}
+	if( result.ec != errc() || p != end )
+		throw invalid_argument( cidr + " is not a valid IPv4 network" );
+
+	prefix = length;
+	network = addr.toHostInt() & mask();
+}
+
+CharsResult IPv4Network::prefixFromChars( const char *text, size_t len,
+		unsigned int &prefix ) noexcept
+{
+	const char *end = text + len;
+	const char *p = text;
+	unsigned int value = 0;
+
+	// Con ceros a la izquierda o más de dos dígitos nunca es válido
+	for( int digits = 0 ; p < end && *p >= '0' && *p <= '9' ; p++, digits++ ){
+		if( digits == 2 || ( digits == 1 && !value ) )
+			return CharsResult{ text, errc::invalid_argument };
+		value = value * 10 + ( *p - '0' );
+	}
+	if( p == text || value > 32 )
+		return CharsResult{ text, errc::invalid_argument };
+
+	prefix = value;
+	return CharsResult{ p, errc() };
+}
+
+string IPv4Network::toString( void ) const
+{
+	char buffer[IPv4Addr::MaxStringLen + 3];
+	char *p = getAddress().toChars( buffer );
+
+	*p++ = '/';
+	if( prefix >= 10 )
+		*p++ = '0' + prefix / 10;
+	*p++ = '0' + prefix % 10;
+	return string( buffer, p );
+}
+
+pair<IPv4Network, IPv4Network> IPv4Network::split( void ) const
+{
+	if( prefix == 32 )
+		throw out_of_range( "A /32 network can not be split" );
+
+	IPv4Network low, high;
+	low.prefix = high.prefix = prefix + 1;
+	low.network = network;
+	high.network = network | ( 1U << ( 31 - prefix ) );
+	return make_pair( low, high );
+}
@@ -0,0 +1,418 @@
+#include <reroman/ipv4prefixset.hpp>
+
+using namespace std;
+using namespace reroman;
+
+constexpr uint32_t IPv4PrefixSet::Empty;
+constexpr uint32_t IPv4PrefixSet::Full;
+constexpr uint64_t IPv4PrefixSet::End;
+constexpr unsigned int IPv4PrefixSet::Stride;
+
+namespace
+{
+	struct Frame
+	{
+		uint32_t ref;
+		uint32_t base;
+		unsigned int depth;
+	};
+
+	// Recorre un rango como la secuencia mínima de bloques CIDR alineados
+	template <typename F>
+	void forEachBlock( const IPv4Range &range, F f )
+	{
+		uint64_t first = range.getFirst().toHostInt();
+		const uint64_t end = first + range.getSize();
+
+		while( first < end ){
+			unsigned int prefix = first ? 32 - __builtin_ctz( first ) : 0;
+
+			while( ( 1ULL << ( 32 - prefix ) ) > end - first )
+				prefix++;
+			f( static_cast<uint32_t>( first ), prefix );
+			first += 1ULL << ( 32 - prefix );
+		}
+	}
+}
+
+IPv4PrefixSet::IPv4PrefixSet( initializer_list<IPv4Network> nets )
+{
+	for( const auto &net : nets )
+		insert( net );
+}
+
+bool IPv4PrefixSet::contains( const IPv4Network &net ) const noexcept
+{
+	const uint32_t value = net.getAddress().toHostInt();
+	uint32_t ref = root;
+
+	for( unsigned int depth = 0 ; ref > Full && depth < net.getPrefix() ; depth++ )
+		ref = nodes[ref].child[( value >> ( 31 - depth ) ) & 1];
+	return ref == Full;
+}
+
+bool IPv4PrefixSet::longestMatch( const IPv4Addr &addr, IPv4Network &net ) const noexcept
+{
+	const uint32_t value = addr.toHostInt();
+	uint32_t ref = root;
+	unsigned int depth = 0;
+
+	for( ; ref > Full ; depth++ )
+		ref = nodes[ref].child[( value >> ( 31 - depth ) ) & 1];
+	if( ref != Full )
+		return false;
+	net = IPv4Network( addr, depth );
+	return true;
+}
+
+uint64_t IPv4PrefixSet::getSize( void ) const noexcept
+{
+	Frame stack[33];
+	int top = 0;
+	uint64_t size = 0;
+
+	stack[top++] = Frame{ root, 0, 0 };
+	while( top ){
+		const Frame f = stack[--top];
+
+		if( f.ref == Full )
+			size += 1ULL << ( 32 - f.depth );
+		else if( f.ref != Empty ){
+			stack[top++] = Frame{ nodes[f.ref].child[1], 0, f.depth + 1 };
+			stack[top++] = Frame{ nodes[f.ref].child[0], 0, f.depth + 1 };
+		}
+	}
+	return size;
+}
+
+vector<IPv4Network> IPv4PrefixSet::getNetworks( void ) const
+{
+	vector<IPv4Network> nets;
+	Frame stack[33];
+	int top = 0;
+
+	stack[top++] = Frame{ root, 0, 0 };
+	while( top ){
+		const Frame f = stack[--top];
+
+		if( f.ref == Full )
+			nets.emplace_back( IPv4Addr( htonl( f.base ) ), f.depth );
+		else if( f.ref != Empty ){
+			stack[top++] = Frame{ nodes[f.ref].child[1],
+				f.base | ( 1U << ( 31 - f.depth ) ), f.depth + 1 };
+			stack[top++] = Frame{ nodes[f.ref].child[0], f.base, f.depth + 1 };
+		}
+	}
+	return nets;
+}
+
+void IPv4PrefixSet::insert( const IPv4Network &net )
+{
+	lookup.clear();
+	root = insert( root, net.getAddress().toHostInt(), 0, net.getPrefix() );
+}
+
+void IPv4PrefixSet::insert( const IPv4Range &range )
+{
+	lookup.clear();
+	forEachBlock( range, [this]( uint32_t net, unsigned int prefix ){
+			root = insert( root, net, 0, prefix );
+		} );
+}
+
+void IPv4PrefixSet::remove( const IPv4Network &net )
+{
+	lookup.clear();
+	root = remove( root, net.getAddress().toHostInt(), 0, net.getPrefix() );
+}
+
+void IPv4PrefixSet::remove( const IPv4Range &range )
+{
+	lookup.clear();
+	forEachBlock( range, [this]( uint32_t net, unsigned int prefix ){
+			root = remove( root, net, 0, prefix );
+		} );
+}
+
+void IPv4PrefixSet::clear( void ) noexcept
+{
+	nodes.resize( 2 );
+	freeNodes.clear();
+	lookup.clear();
+	root = Empty;
+}
+
+void IPv4PrefixSet::optimize( void )
+{
+	lookup.assign( 1, Lookup() );
+	compile( 0, root, 0 );
+	lookup.shrink_to_fit();
+}
+
+IPv4PrefixSet& IPv4PrefixSet::operator|=( const IPv4PrefixSet &set )
+{
+	lookup.clear();
+	if( &set != this )
+		root = unite( root, set, set.root );
+	return *this;
+}
+
+IPv4PrefixSet& IPv4PrefixSet::operator-=( const IPv4PrefixSet &set )
+{
+	lookup.clear();
+	if( &set == this )
+		clear();
+	else
+		root = subtract( root, set, set.root );
+	return *this;
+}
+
+IPv4PrefixSet& IPv4PrefixSet::operator&=( const IPv4PrefixSet &set )
+{
+	lookup.clear();
+	if( &set != this )
+		root = intersect( root, set, set.root );
+	return *this;
+}
+
+IPv4PrefixSet IPv4PrefixSet::operator|( const IPv4PrefixSet &set ) const
+{
+	IPv4PrefixSet result( *this );
+	return result |= set;
+}
+
+IPv4PrefixSet IPv4PrefixSet::operator-( const IPv4PrefixSet &set ) const
+{
+	IPv4PrefixSet result( *this );
+	return result -= set;
+}
+
+IPv4PrefixSet IPv4PrefixSet::operator&( const IPv4PrefixSet &set ) const
+{
+	IPv4PrefixSet result( *this );
+	return result &= set;
+}
+
+bool IPv4PrefixSet::operator==( const IPv4PrefixSet &set ) const noexcept
+{
+	pair<uint32_t, uint32_t> stack[33];
+	int top = 0;
+
+	stack[top++] = make_pair( root, set.root );
+	while( top ){
+		const auto p = stack[--top];
+
+		if( p.first <= Full || p.second <= Full ){
+			if( p.first != p.second )
+				return false;
+			continue;
+		}
+		stack[top++] = make_pair( nodes[p.first].child[1],
+				set.nodes[p.second].child[1] );
+		stack[top++] = make_pair( nodes[p.first].child[0],
+				set.nodes[p.second].child[0] );
+	}
+	return true;
+}
+
+uint32_t IPv4PrefixSet::allocate( uint32_t left, uint32_t right )
+{
+	uint32_t ref;
+
+	if( freeNodes.empty() ){
+		ref = nodes.size();
+		nodes.push_back( Node{ { left, right } } );
+	}
+	else{
+		ref = freeNodes.back();
+		freeNodes.pop_back();
+		nodes[ref] = Node{ { left, right } };
+	}
+	return ref;
+}
+
+void IPv4PrefixSet::release( uint32_t ref ) noexcept
+{
+	if( ref <= Full )
+		return;
+	release( nodes[ref].child[0] );
+	release( nodes[ref].child[1] );
+	freeNodes.push_back( ref );
+}
+
+uint32_t IPv4PrefixSet::clone( const IPv4PrefixSet &set, uint32_t ref )
+{
+	if( ref <= Full )
+		return ref;
+
+	const uint32_t left = clone( set, set.nodes[ref].child[0] );
+	const uint32_t right = clone( set, set.nodes[ref].child[1] );
+	return allocate( left, right );
+}
+
+uint32_t IPv4PrefixSet::insert( uint32_t ref, uint32_t net, unsigned int depth,
+		unsigned int prefix )
+{
+	if( ref == Full )
+		return Full;
+	if( depth == prefix ){
+		release( ref );
+		return Full;
+	}
+	if( ref == Empty )
+		ref = allocate( Empty, Empty );
+
+	const int bit = ( net >> ( 31 - depth ) ) & 1;
+	const uint32_t child = insert( nodes[ref].child[bit], net, depth + 1, prefix );
+
+	nodes[ref].child[bit] = child;
+	if( nodes[ref].child[!bit] == Full && child == Full ){
+		freeNodes.push_back( ref );
+		return Full;
+	}
+	return ref;
+}
+
+uint32_t IPv4PrefixSet::remove( uint32_t ref, uint32_t net, unsigned int depth,
+		unsigned int prefix )
+{
+	if( ref == Empty )
+		return Empty;
+	if( depth == prefix ){
+		release( ref );
+		return Empty;
+	}
+	if( ref == Full )
+		ref = allocate( Full, Full );
+
+	const int bit = ( net >> ( 31 - depth ) ) & 1;
+	const uint32_t child = remove( nodes[ref].child[bit], net, depth + 1, prefix );
+
+	nodes[ref].child[bit] = child;
+	if( nodes[ref].child[!bit] == Empty && child == Empty ){
+		freeNodes.push_back( ref );
+		return Empty;
+	}
+	return ref;
+}
+
+uint32_t IPv4PrefixSet::unite( uint32_t ref, const IPv4PrefixSet &set, uint32_t other )
+{
+	if( other == Empty || ref == Full )
+		return ref;
+	if( other == Full ){
+		release( ref );
+		return Full;
+	}
+	if( ref == Empty )
+		return clone( set, other );
+
+	for( int bit = 0 ; bit < 2 ; bit++ ){
+		const uint32_t child = unite( nodes[ref].child[bit], set,
+				set.nodes[other].child[bit] );
+		nodes[ref].child[bit] = child;
+	}
+	if( nodes[ref].child[0] == Full && nodes[ref].child[1] == Full ){
+		freeNodes.push_back( ref );
+		return Full;
+	}
+	return ref;
+}
+
+uint32_t IPv4PrefixSet::subtract( uint32_t ref, const IPv4PrefixSet &set, uint32_t other )
+{
+	if( ref == Empty || other == Empty )
+		return ref;
+	if( other == Full ){
+		release( ref );
+		return Empty;
+	}
+	if( ref == Full )
+		ref = allocate( Full, Full );
+
+	for( int bit = 0 ; bit < 2 ; bit++ ){
+		const uint32_t child = subtract( nodes[ref].child[bit], set,
+				set.nodes[other].child[bit] );
+		nodes[ref].child[bit] = child;
+	}
+	if( nodes[ref].child[0] == Empty && nodes[ref].child[1] == Empty ){
+		freeNodes.push_back( ref );
+		return Empty;
+	}
+	return ref;
+}
+
+uint32_t IPv4PrefixSet::intersect( uint32_t ref, const IPv4PrefixSet &set, uint32_t other )
+{
+	if( ref == Empty || other == Full )
+		return ref;
+	if( other == Empty ){
+		release( ref );
+		return Empty;
+	}
+	if( ref == Full )
+		return clone( set, other );
+
+	for( int bit = 0 ; bit < 2 ; bit++ ){
+		const uint32_t child = intersect( nodes[ref].child[bit], set,
+				set.nodes[other].child[bit] );
+		nodes[ref].child[bit] = child;
+	}
+	if( nodes[ref].child[0] == Empty && nodes[ref].child[1] == Empty ){
+		freeNodes.push_back( ref );
+		return Empty;
+	}
+	return ref;
+}
+
+bool IPv4PrefixSet::seek( uint64_t from, uint64_t &first, uint64_t &blockEnd ) const noexcept
+{
+	Frame stack[33];
+	int top = 0;
+
+	stack[top++] = Frame{ root, 0, 0 };
+	while( top ){
+		const Frame f = stack[--top];
+		const uint64_t end = f.base + ( 1ULL << ( 32 - f.depth ) );
+
+		if( f.ref == Empty || end <= from )
+			continue;
+		if( f.ref == Full ){
+			first = max<uint64_t>( f.base, from );
+			blockEnd = end;
+			return true;
+		}
+		stack[top++] = Frame{ nodes[f.ref].child[1],
+			f.base | ( 1U << ( 31 - f.depth ) ), f.depth + 1 };
+		stack[top++] = Frame{ nodes[f.ref].child[0], f.base, f.depth + 1 };
+	}
+	first = blockEnd = End;
+	return false;
+}
+
+void IPv4PrefixSet::compile( uint32_t index, uint32_t ref, unsigned int depth )
+{
+	const unsigned int stride = depth + Stride > 32 ? 32 - depth : Stride;
+	uint32_t children[1 << Stride];
+	unsigned int count = 0;
+	Lookup node = { 0, 0, 0 };
+
+	for( uint32_t slot = 0 ; slot < ( 1U << stride ) ; slot++ ){
+		uint32_t r = ref;
+
+		for( int bit = stride - 1 ; bit >= 0 && r > Full ; bit-- )
+			r = nodes[r].child[( slot >> bit ) & 1];
+		if( r == Full )
+			node.full |= 1ULL << slot;
+		else if( r != Empty ){
+			node.internal |= 1ULL << slot;
+			children[count++] = r;
+		}
+	}
+
+	node.base = lookup.size();
+	lookup[index] = node;
+	lookup.resize( lookup.size() + count );
+	for( unsigned int i = 0 ; i < count ; i++ )
+		compile( node.base + i, children[i], depth + stride );
+}
@@ -0,0 +1,36 @@
+#include <reroman/ipv4range.hpp>
+#include <algorithm>
+
+using namespace std;
+using namespace reroman;
+
+pair<IPv4Range, IPv4Range> IPv4Range::split( void ) const noexcept
+{
+	return make_pair( shard( 0, 2 ), shard( 1, 2 ) );
+}
+
+IPv4Range IPv4Range::shard( unsigned int index, unsigned int count ) const noexcept
+{
+	IPv4Range result;
+
+	if( index >= count )
+		return result;
+
+	// Las primeras size % count partes tienen una dirección más
+	const uint64_t base = size / count;
+	const uint64_t extra = size % count;
+	result.first = static_cast<uint32_t>( first + index * base +
+			min<uint64_t>( index, extra ) );
+	result.size = base + ( index < extra ? 1 : 0 );
+	return result;
+}
+
+vector<IPv4Range> IPv4Range::shards( unsigned int count ) const
+{
+	vector<IPv4Range> result;
+
+	result.reserve( count );
+	for( unsigned int i = 0 ; i < count ; i++ )
+		result.push_back( shard( i, count ) );
+	return result;
+}
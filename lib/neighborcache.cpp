@@ -0,0 +1,273 @@
+#include <reroman/arp/neighborcache.hpp>
+#include <reroman/hashmix.hpp>
+#include <chrono>
+#include <stdexcept>
+#include <system_error>
+
+using namespace std;
+using namespace reroman;
+using namespace reroman::arp;
+
+namespace
+{
+	typedef chrono::steady_clock Clock;
+
+	// Número de ranuras revisadas a partir de la posición de una dirección
+	constexpr size_t MaxProbe = 8;
+	// Marca de entrada negativa dentro del campo de dirección física
+	constexpr uint64_t NegativeBit = 1ULL << 63;
+
+	int64_t now( void )
+	{
+		return chrono::duration_cast<chrono::milliseconds>(
+				Clock::now().time_since_epoch() ).count();
+	}
+
+	// La dirección está en orden de red, así que los octetos del host están
+	// en los bits altos y deben mezclarse con los bajos antes de enmascarar
+	size_t hashOf( uint32_t ip )
+	{
+		return static_cast<size_t>( hashMix( ip ) );
+	}
+}
+
+NeighborCache::NeighborCache( ARPSocket &sock, const NetworkInterface &nic,
+		unsigned int ttl, unsigned int negativeTtl, size_t capacity ) :
+	sock( sock ),
+	nic( nic ),
+	ttl( ttl ),
+	negativeTtl( negativeTtl ),
+	hits( 0 ),
+	negativeHits( 0 ),
+	misses( 0 ),
+	stale( 0 )
+{
+	size_t size = MaxProbe;
+
+	while( size < capacity )
+		size <<= 1;
+	mask = size - 1;
+	slots.reset( new Slot[size] );
+
+	for( size_t i = 0 ; i < size ; i++ ){
+		slots[i].seq.store( 0, memory_order_relaxed );
+		slots[i].ip.store( 0, memory_order_relaxed );
+		slots[i].hw.store( 0, memory_order_relaxed );
+		slots[i].expires.store( 0, memory_order_relaxed );
+	}
+}
+
+NeighborCache::~NeighborCache()
+{
+	stopRefresh();
+}
+
+CacheStatus NeighborCache::lookup( const IPv4Addr &ip, HwAddr *result ) const noexcept
+{
+	uint64_t hw;
+	int64_t expires;
+
+	if( !read( ip.toNetworkInt(), hw, expires ) ){
+		misses.fetch_add( 1, memory_order_relaxed );
+		return CacheStatus::MISS;
+	}
+	if( !(hw & NegativeBit) && result )
+		*result = HwAddr::fromUint64( hw );
+
+	if( expires <= now() ){
+		stale.fetch_add( 1, memory_order_relaxed );
+		return CacheStatus::STALE;
+	}
+	if( hw & NegativeBit ){
+		negativeHits.fetch_add( 1, memory_order_relaxed );
+		return CacheStatus::NEGATIVE;
+	}
+	hits.fetch_add( 1, memory_order_relaxed );
+	return CacheStatus::HIT;
+}
+
+NeighborCache::Stats NeighborCache::getStats( void ) const noexcept
+{
+	Stats stats;
+
+	stats.hits = hits.load( memory_order_relaxed );
+	stats.negativeHits = negativeHits.load( memory_order_relaxed );
+	stats.misses = misses.load( memory_order_relaxed );
+	stats.stale = stale.load( memory_order_relaxed );
+	return stats;
+}
+
+bool NeighborCache::resolve( const IPv4Addr &ip, HwAddr *result )
+{
+	switch( lookup( ip, result ) ){
+		case CacheStatus::HIT:
+			return true;
+		case CacheStatus::NEGATIVE:
+			return false;
+		default:
+			break;
+	}
+
+	lock_guard<mutex> lock( writer );
+	const uint32_t key = ip.toNetworkInt();
+	uint64_t hw;
+	int64_t expires;
+
+	// Otro hilo pudo resolverla mientras se esperaba el bloqueo
+	if( read( key, hw, expires ) && expires > now() ){
+		if( hw & NegativeBit )
+			return false;
+		if( result )
+			*result = HwAddr::fromUint64( hw );
+		return true;
+	}
+
+	HwAddr found;
+	if( sock.resolve( ip, nic, &found ) ){
+		write( key, found.toUint64(), now() + ttl );
+		if( result )
+			*result = found;
+		return true;
+	}
+	write( key, NegativeBit, now() + negativeTtl );
+	return false;
+}
+
+void NeighborCache::insert( const IPv4Addr &ip, const HwAddr &hw )
+{
+	lock_guard<mutex> lock( writer );
+	write( ip.toNetworkInt(), hw.toUint64(), now() + ttl );
+}
+
+void NeighborCache::insertNegative( const IPv4Addr &ip )
+{
+	lock_guard<mutex> lock( writer );
+	write( ip.toNetworkInt(), NegativeBit, now() + negativeTtl );
+}
+
+void NeighborCache::invalidate( const IPv4Addr &ip )
+{
+	lock_guard<mutex> lock( writer );
+	const uint32_t key = ip.toNetworkInt();
+	uint64_t hw;
+	int64_t expires;
+
+	if( read( key, hw, expires ) )
+		write( key, hw, 0 );
+}
+
+void NeighborCache::startRefresh( unsigned int ahead )
+{
+	lock_guard<mutex> lock( refreshMutex );
+
+	if( refreshing )
+		throw logic_error( "NeighborCache refresh is already running" );
+	refreshing = true;
+	refresher = thread( &NeighborCache::refresh, this, ahead );
+}
+
+void NeighborCache::stopRefresh( void )
+{
+	{
+		lock_guard<mutex> lock( refreshMutex );
+		refreshing = false;
+	}
+	refreshCond.notify_all();
+	if( refresher.joinable() )
+		refresher.join();
+}
+
+bool NeighborCache::read( uint32_t ip, uint64_t &hw, int64_t &expires ) const noexcept
+{
+	if( !ip )
+		return false;
+
+	const size_t start = hashOf( ip );
+	for( size_t i = 0 ; i < MaxProbe ; i++ ){
+		const Slot &slot = slots[(start + i) & mask];
+		uint32_t seq, key;
+
+		do{
+			while( (seq = slot.seq.load( memory_order_acquire )) & 1 )
+				;
+			key = slot.ip.load( memory_order_relaxed );
+			hw = slot.hw.load( memory_order_relaxed );
+			expires = slot.expires.load( memory_order_relaxed );
+			atomic_thread_fence( memory_order_acquire );
+		}while( slot.seq.load( memory_order_relaxed ) != seq );
+
+		if( key == ip )
+			return true;
+		// Las ranuras nunca se vacían, así que una vacía termina la búsqueda
+		if( !key )
+			return false;
+	}
+	return false;
+}
+
+void NeighborCache::write( uint32_t ip, uint64_t hw, int64_t expires ) noexcept
+{
+	if( !ip )
+		return;
+
+	// Se prefiere la ranura con la misma dirección, luego una vacía y
+	// por último la que expira primero
+	const size_t start = hashOf( ip );
+	Slot *target = nullptr;
+	for( size_t i = 0 ; i < MaxProbe ; i++ ){
+		Slot &slot = slots[(start + i) & mask];
+		const uint32_t key = slot.ip.load( memory_order_relaxed );
+
+		if( key == ip || !key ){
+			target = &slot;
+			break;
+		}
+		if( !target || slot.expires.load( memory_order_relaxed ) <
+				target->expires.load( memory_order_relaxed ) )
+			target = &slot;
+	}
+
+	const uint32_t seq = target->seq.load( memory_order_relaxed );
+	target->seq.store( seq + 1, memory_order_relaxed );
+	atomic_thread_fence( memory_order_release );
+	target->ip.store( ip, memory_order_relaxed );
+	target->hw.store( hw, memory_order_relaxed );
+	target->expires.store( expires, memory_order_relaxed );
+	target->seq.store( seq + 2, memory_order_release );
+}
+
+void NeighborCache::refresh( unsigned int ahead )
+{
+	const chrono::milliseconds period( max( ahead / 2, 10U ) );
+	unique_lock<mutex> lock( refreshMutex );
+
+	while( !refreshCond.wait_for( lock, period, [this]{ return !refreshing; } ) ){
+		lock.unlock();
+
+		vector<IPv4Addr> targets;
+		const int64_t limit = now() + ahead;
+		for( size_t i = 0 ; i <= mask ; i++ ){
+			uint64_t hw;
+			int64_t expires;
+			const uint32_t key = slots[i].ip.load( memory_order_relaxed );
+
+			// Las entradas ya expiradas se renuevan solo al consultarse
+			if( read( key, hw, expires ) && !(hw & NegativeBit) &&
+					expires > now() && expires <= limit )
+				targets.push_back( IPv4Addr( key ) );
+		}
+
+		if( !targets.empty() ){
+			lock_guard<mutex> guard( writer );
+			try{
+				sock.resolveMany( targets, nic,
+						[this]( const IPv4Addr &ip, const HwAddr &hw ){
+							write( ip.toNetworkInt(), hw.toUint64(), now() + ttl );
+						} );
+			}catch( const system_error& ){
+				// Un error transitorio no detiene la renovación
+			}
+		}
+		lock.lock();
+	}
+}
@@ -0,0 +1,204 @@
+#include <reroman/arp/neighbormonitor.hpp>
+#include <system_error>
+
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+using namespace std;
+using namespace reroman;
+using namespace reroman::arp;
+
+namespace
+{
+	// Mensajes leídos por llamada a recvmmsg() y tamaño de cada uno
+	constexpr size_t MaxBatch = 32;
+	constexpr size_t MessageSize = 8192;
+	// Buffer de recepción solicitado para absorber ráfagas de cambios
+	constexpr int RcvBufSize = 1 << 22;
+
+	uint64_t keyOf( const NeighborEntry &entry )
+	{
+		return static_cast<uint64_t>( entry.ifindex ) << 32 |
+			entry.ip.toNetworkInt();
+	}
+
+	bool differs( const NeighborEntry &a, const NeighborEntry &b )
+	{
+		return a.state != b.state || a.flags != b.flags || a.hw != b.hw;
+	}
+}
+
+NeighborMonitor::NeighborMonitor( void ) :
+	buffer( MaxBatch * MessageSize )
+{
+	sock = socket( AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK,
+			NETLINK_ROUTE );
+	if( sock < 0 )
+		throw system_error( errno, generic_category(), "NeighborMonitor" );
+
+	struct sockaddr_nl addr;
+	memset( &addr, 0, sizeof(addr) );
+	addr.nl_family = AF_NETLINK;
+	addr.nl_groups = RTMGRP_NEIGH;
+	if( ::bind( sock, reinterpret_cast<struct sockaddr*>( &addr ),
+				sizeof(addr) ) < 0 ){
+		int err = errno;
+		close( sock );
+		throw system_error( err, generic_category(), "NeighborMonitor" );
+	}
+
+	// SO_RCVBUFFORCE ignora el límite del sistema pero requiere privilegios
+	if( setsockopt( sock, SOL_SOCKET, SO_RCVBUFFORCE, &RcvBufSize,
+				sizeof(RcvBufSize) ) < 0 )
+		setsockopt( sock, SOL_SOCKET, SO_RCVBUF, &RcvBufSize,
+				sizeof(RcvBufSize) );
+
+	// La suscripción precede a la lectura de la tabla para no perder cambios
+	try{
+		resync( nullptr );
+	}catch( ... ){
+		close( sock );
+		throw;
+	}
+}
+
+NeighborMonitor::~NeighborMonitor()
+{
+	close( sock );
+}
+
+void NeighborMonitor::getEntries( vector<NeighborEntry> &entries ) const
+{
+	entries.clear();
+	entries.reserve( known.size() );
+	for( auto &item : known )
+		entries.push_back( item.second );
+}
+
+size_t NeighborMonitor::poll( const EventHandler &handler )
+{
+	struct mmsghdr msgs[MaxBatch];
+	struct iovec iov[MaxBatch];
+	size_t count = 0;
+
+	memset( msgs, 0, sizeof(msgs) );
+	for( size_t i = 0 ; i < MaxBatch ; i++ ){
+		iov[i].iov_base = &buffer[i * MessageSize];
+		iov[i].iov_len = MessageSize;
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	while( true ){
+		int n = recvmmsg( sock, msgs, MaxBatch, MSG_DONTWAIT, nullptr );
+		if( n < 0 ){
+			if( errno == EAGAIN || errno == EWOULDBLOCK )
+				return count;
+			if( errno == EINTR )
+				continue;
+			if( errno == ENOBUFS ){
+				// Se perdieron mensajes; la tabla se lee de nuevo
+				overruns++;
+				count += resync( &handler );
+				continue;
+			}
+			throw system_error( errno, generic_category(), "NeighborMonitor::poll" );
+		}
+
+		for( int i = 0 ; i < n ; i++ ){
+			if( msgs[i].msg_hdr.msg_flags & MSG_TRUNC )
+				continue;
+
+			int len = msgs[i].msg_len;
+			for( auto msg = static_cast<struct nlmsghdr*>( iov[i].iov_base ) ;
+					NLMSG_OK( msg, len ) ; msg = NLMSG_NEXT( msg, len ) ){
+				NeighborEntry entry;
+				if( !NeighborTable::parse( msg, entry ) )
+					continue;
+
+				const uint64_t key = keyOf( entry );
+				if( msg->nlmsg_type == RTM_DELNEIGH ){
+					known.erase( key );
+					emit( NeighborEventType::REMOVED, entry, handler );
+				}
+				else{
+					auto it = known.find( key );
+					const bool added = it == known.end();
+					known[key] = entry;
+					emit( added ? NeighborEventType::ADDED :
+							NeighborEventType::CHANGED, entry, handler );
+				}
+				count++;
+			}
+		}
+
+		if( static_cast<size_t>( n ) < MaxBatch )
+			return count;
+	}
+}
+
+size_t NeighborMonitor::wait( const EventHandler &handler, int msecs )
+{
+	struct pollfd pfd{ sock, POLLIN, 0 };
+
+	int ready = ::poll( &pfd, 1, msecs );
+	if( ready < 0 && errno != EINTR )
+		throw system_error( errno, generic_category(), "poll" );
+	return ready > 0 ? poll( handler ) : 0;
+}
+
+void NeighborMonitor::emit( NeighborEventType type, const NeighborEntry &entry,
+		const EventHandler &handler )
+{
+	NeighborEvent event;
+	event.type = type;
+	event.entry = entry;
+
+	auto it = nics.find( entry.ifindex );
+	if( it != nics.end() )
+		event.nic = it->second;
+	else if( event.nic.bind( entry.ifindex ) )
+		nics.emplace( entry.ifindex, event.nic );
+
+	handler( event );
+}
+
+size_t NeighborMonitor::resync( const EventHandler *handler )
+{
+	unordered_map<uint64_t, NeighborEntry> current;
+	size_t count = 0;
+
+	current.reserve( known.size() );
+	table.dump( [&current]( const NeighborEntry &entry ){
+			current.emplace( keyOf( entry ), entry );
+		} );
+
+	if( handler ){
+		for( auto &item : current ){
+			auto it = known.find( item.first );
+			if( it == known.end() )
+				emit( NeighborEventType::ADDED, item.second, *handler );
+			else if( differs( it->second, item.second ) )
+				emit( NeighborEventType::CHANGED, item.second, *handler );
+			else
+				continue;
+			count++;
+		}
+		for( auto &item : known )
+			if( !current.count( item.first ) ){
+				emit( NeighborEventType::REMOVED, item.second, *handler );
+				count++;
+			}
+	}
+
+	known.swap( current );
+	// Las interfaces pudieron cambiar mientras se perdían mensajes
+	nics.clear();
+	return count;
+}
@@ -0,0 +1,311 @@
+#include <reroman/arp/neighbortable.hpp>
+#include <stdexcept>
+#include <system_error>
+
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/neighbour.h>
+
+using namespace std;
+using namespace reroman;
+using namespace reroman::arp;
+
+namespace
+{
+	// Tamaño del buffer de recepción; el kernel envía hasta 32 KiB por lectura
+	constexpr size_t BufferSize = 1 << 16;
+	// Máximo de mensajes por envío en commit(). Cada confirmación ocupa un
+	// buffer propio en el socket, así que el límite evita desbordarlo
+	constexpr size_t MaxChunk = 128;
+
+	// Los tiempos de nda_cacheinfo se expresan en ticks de reloj
+	uint32_t ticksToMsecs( uint32_t ticks )
+	{
+		static const long hz = sysconf( _SC_CLK_TCK );
+		return static_cast<uint32_t>( static_cast<uint64_t>( ticks ) * 1000 /
+				( hz > 0 ? hz : 100 ) );
+	}
+
+	void addAttr( struct nlmsghdr *msg, uint16_t type, const void *data,
+			size_t len )
+	{
+		struct rtattr *rta = reinterpret_cast<struct rtattr*>(
+				reinterpret_cast<char*>( msg ) + NLMSG_ALIGN( msg->nlmsg_len ) );
+
+		rta->rta_type = type;
+		rta->rta_len = RTA_LENGTH( len );
+		memcpy( RTA_DATA( rta ), data, len );
+		msg->nlmsg_len = NLMSG_ALIGN( msg->nlmsg_len ) + RTA_ALIGN( rta->rta_len );
+	}
+}
+
+NeighborTable::NeighborTable( void ) :
+	buffer( BufferSize )
+{
+	sock = socket( AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE );
+	if( sock < 0 )
+		throw system_error( errno, generic_category(), "NeighborTable" );
+
+	struct sockaddr_nl addr;
+	memset( &addr, 0, sizeof(addr) );
+	addr.nl_family = AF_NETLINK;
+	if( ::bind( sock, reinterpret_cast<struct sockaddr*>( &addr ),
+				sizeof(addr) ) < 0 ){
+		int err = errno;
+		close( sock );
+		throw system_error( err, generic_category(), "NeighborTable" );
+	}
+
+	// Permite que el kernel filtre por interfaz; los kernels antiguos
+	// no la soportan y se filtra al procesar las respuestas
+	int one = 1;
+	setsockopt( sock, SOL_NETLINK, NETLINK_GET_STRICT_CHK, &one, sizeof(one) );
+	// Las confirmaciones de error no incluyen el mensaje original
+	setsockopt( sock, SOL_NETLINK, NETLINK_CAP_ACK, &one, sizeof(one) );
+}
+
+NeighborTable::~NeighborTable()
+{
+	close( sock );
+}
+
+size_t NeighborTable::dump( const EntryHandler &handler, int ifindex,
+		uint16_t states )
+{
+	struct
+	{
+		struct nlmsghdr hdr;
+		struct ndmsg nd;
+		char attrs[RTA_SPACE( sizeof(uint32_t) )];
+	} req;
+
+	memset( &req, 0, sizeof(req) );
+	req.hdr.nlmsg_len = NLMSG_LENGTH( sizeof(req.nd) );
+	req.hdr.nlmsg_type = RTM_GETNEIGH;
+	req.hdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+	req.hdr.nlmsg_seq = ++seq;
+	req.nd.ndm_family = AF_INET;
+	if( ifindex ){
+		const uint32_t index = ifindex;
+		addAttr( &req.hdr, NDA_IFINDEX, &index, sizeof(index) );
+	}
+
+	if( send( sock, &req, req.hdr.nlmsg_len, 0 ) < 0 )
+		throw system_error( errno, generic_category(), "NeighborTable::dump" );
+
+	size_t count = 0;
+	while( true ){
+		ssize_t len = recv( sock, buffer.data(), buffer.size(), 0 );
+		if( len < 0 ){
+			if( errno == EINTR )
+				continue;
+			throw system_error( errno, generic_category(), "NeighborTable::dump" );
+		}
+
+		for( auto msg = reinterpret_cast<struct nlmsghdr*>( buffer.data() ) ;
+				NLMSG_OK( msg, len ) ; msg = NLMSG_NEXT( msg, len ) ){
+			if( msg->nlmsg_seq != seq )
+				continue;
+			if( msg->nlmsg_type == NLMSG_DONE )
+				return count;
+			if( msg->nlmsg_type == NLMSG_ERROR ){
+				auto err = static_cast<struct nlmsgerr*>( NLMSG_DATA( msg ) );
+				throw system_error( -err->error, generic_category(),
+						"NeighborTable::dump" );
+			}
+
+			NeighborEntry entry;
+			if( parse( msg, entry ) && ( !ifindex || entry.ifindex == ifindex )
+					&& ( states == 0xffff || entry.state & states ) ){
+				handler( entry );
+				count++;
+			}
+		}
+	}
+}
+
+size_t NeighborTable::dump( vector<NeighborEntry> &entries, int ifindex,
+		uint16_t states )
+{
+	entries.clear();
+	return dump( [&entries]( const NeighborEntry &entry ){
+			entries.push_back( entry );
+		}, ifindex, states );
+}
+
+void NeighborTable::queueAdd( const NetworkInterface &nic, const IPv4Addr &ip,
+		const HwAddr &hw, NeighborState state )
+{
+	queue( RTM_NEWNEIGH, NLM_F_CREATE | NLM_F_EXCL, nic, ip, &hw,
+			static_cast<uint16_t>( state ) );
+}
+
+void NeighborTable::queueReplace( const NetworkInterface &nic,
+		const IPv4Addr &ip, const HwAddr &hw, NeighborState state )
+{
+	queue( RTM_NEWNEIGH, NLM_F_CREATE | NLM_F_REPLACE, nic, ip, &hw,
+			static_cast<uint16_t>( state ) );
+}
+
+void NeighborTable::queueRemove( const NetworkInterface &nic, const IPv4Addr &ip )
+{
+	queue( RTM_DELNEIGH, 0, nic, ip, nullptr, 0 );
+}
+
+size_t NeighborTable::queueFlush( const NetworkInterface &nic, uint16_t states )
+{
+	if( !nic.isBinded() )
+		throw invalid_argument( "Invalid network interface" );
+
+	vector<NeighborEntry> entries;
+	dump( entries, nic.getIndex(), states );
+	for( auto &entry : entries )
+		queueRemove( nic, entry.ip );
+	return entries.size();
+}
+
+size_t NeighborTable::commit( vector<int> *results )
+{
+	const size_t total = offsets.size();
+	size_t succeeded = 0;
+
+	if( results )
+		results->assign( total, 0 );
+
+	for( size_t i = 0 ; i < total ; ){
+		const size_t first = i;
+		const size_t begin = offsets[first];
+		const uint32_t firstSeq = seq + 1;
+		size_t end = begin;
+
+		while( i < total && i - first < MaxChunk ){
+			const size_t next = i + 1 < total ? offsets[i + 1] : batch.size();
+			reinterpret_cast<struct nlmsghdr*>( &batch[offsets[i]] )->nlmsg_seq = ++seq;
+			end = next;
+			i++;
+		}
+
+		if( send( sock, &batch[begin], end - begin, 0 ) < 0 ){
+			int err = errno;
+			discard();
+			throw system_error( err, generic_category(), "NeighborTable::commit" );
+		}
+
+		size_t acked = 0;
+		while( acked < i - first ){
+			ssize_t len = recv( sock, buffer.data(), buffer.size(), 0 );
+			if( len < 0 ){
+				if( errno == EINTR )
+					continue;
+				int err = errno;
+				discard();
+				throw system_error( err, generic_category(), "NeighborTable::commit" );
+			}
+
+			for( auto msg = reinterpret_cast<struct nlmsghdr*>( buffer.data() ) ;
+					NLMSG_OK( msg, len ) ; msg = NLMSG_NEXT( msg, len ) ){
+				if( msg->nlmsg_type != NLMSG_ERROR || msg->nlmsg_seq < firstSeq
+						|| msg->nlmsg_seq > seq )
+					continue;
+
+				auto ack = static_cast<struct nlmsgerr*>( NLMSG_DATA( msg ) );
+				if( !ack->error )
+					succeeded++;
+				if( results )
+					(*results)[first + msg->nlmsg_seq - firstSeq] = -ack->error;
+				acked++;
+			}
+		}
+	}
+
+	discard();
+	return succeeded;
+}
+
+void NeighborTable::queue( uint16_t type, uint16_t flags,
+		const NetworkInterface &nic, const IPv4Addr &ip, const HwAddr *hw,
+		uint16_t state )
+{
+	if( !nic.isBinded() )
+		throw invalid_argument( "Invalid network interface" );
+
+	const size_t offset = batch.size();
+	batch.resize( offset + NLMSG_SPACE( sizeof(struct ndmsg) ) +
+			RTA_SPACE( IPv4Addr::IPv4AddrLen ) + RTA_SPACE( HwAddr::HwAddrLen ) );
+
+	auto msg = reinterpret_cast<struct nlmsghdr*>( &batch[offset] );
+	msg->nlmsg_len = NLMSG_LENGTH( sizeof(struct ndmsg) );
+	msg->nlmsg_type = type;
+	msg->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | flags;
+
+	auto nd = static_cast<struct ndmsg*>( NLMSG_DATA( msg ) );
+	nd->ndm_family = AF_INET;
+	nd->ndm_ifindex = nic.getIndex();
+	nd->ndm_state = state;
+
+	const uint32_t dst = ip.toNetworkInt();
+	addAttr( msg, NDA_DST, &dst, sizeof(dst) );
+	if( hw )
+		addAttr( msg, NDA_LLADDR, hw->getData(), HwAddr::HwAddrLen );
+
+	batch.resize( offset + NLMSG_ALIGN( msg->nlmsg_len ) );
+	offsets.push_back( offset );
+}
+
+bool NeighborTable::parse( const struct nlmsghdr *msg, NeighborEntry &entry )
+{
+	if( ( msg->nlmsg_type != RTM_NEWNEIGH && msg->nlmsg_type != RTM_DELNEIGH )
+			|| msg->nlmsg_len < NLMSG_LENGTH( sizeof(struct ndmsg) ) )
+		return false;
+
+	auto nd = static_cast<const struct ndmsg*>( NLMSG_DATA( msg ) );
+	if( nd->ndm_family != AF_INET )
+		return false;
+
+	entry.ifindex = nd->ndm_ifindex;
+	entry.state = nd->ndm_state;
+	entry.flags = nd->ndm_flags;
+
+	bool hasDst = false;
+	int len = NLMSG_PAYLOAD( msg, sizeof(struct ndmsg) );
+	auto rta = reinterpret_cast<const struct rtattr*>(
+			reinterpret_cast<const char*>( nd ) + NLMSG_ALIGN( sizeof(*nd) ) );
+	for( ; RTA_OK( rta, len ) ;
+			rta = RTA_NEXT( rta, len ) ){
+		const size_t size = RTA_PAYLOAD( rta );
+
+		switch( rta->rta_type ){
+			case NDA_DST:
+				if( size == IPv4Addr::IPv4AddrLen ){
+					uint32_t ip;
+					memcpy( &ip, RTA_DATA( rta ), sizeof(ip) );
+					entry.ip = IPv4Addr( ip );
+					hasDst = true;
+				}
+				break;
+			case NDA_LLADDR:
+				if( size == HwAddr::HwAddrLen )
+					entry.hw.setData( static_cast<const uint8_t*>( RTA_DATA( rta ) ) );
+				break;
+			case NDA_PROBES:
+				if( size == sizeof(uint32_t) )
+					memcpy( &entry.probes, RTA_DATA( rta ), sizeof(uint32_t) );
+				break;
+			case NDA_CACHEINFO:
+				if( size >= sizeof(struct nda_cacheinfo) ){
+					struct nda_cacheinfo info;
+					memcpy( &info, RTA_DATA( rta ), sizeof(info) );
+					entry.confirmed = ticksToMsecs( info.ndm_confirmed );
+					entry.used = ticksToMsecs( info.ndm_used );
+					entry.updated = ticksToMsecs( info.ndm_updated );
+				}
+				break;
+		}
+	}
+	return hasDst;
+}
@@ -1,4 +1,11 @@
 #include <reroman/networkinterface.hpp>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
 
 #include <cerrno>
 #include <cstring>
@@ -6,12 +13,177 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <sys/eventfd.h>
 #include <net/if.h>
+#include <netinet/in.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <poll.h>
 #include <unistd.h>
 
 using namespace std;
 using namespace reroman;
 
+struct NetworkInterface::Shared
+{
+	shared_ptr<const Snapshot> snap;	// Se accede con atomic_load/atomic_store
+};
+
+namespace
+{
+	// Se incrementa con cada cambio notificado por netlink; una instantánea
+	// con otra generación se considera inválida
+	atomic<uint64_t> generation( 0 );
+
+	/*
+	 * Hilo que escucha los cambios de interfaces y direcciones. Es un
+	 * objeto estático para detener el hilo al terminar el programa.
+	 */
+	class Watcher
+	{
+	public:
+		~Watcher()
+		{
+			stop();
+		}
+
+		bool start( void )
+		{
+			lock_guard<mutex> lock( mtx );
+
+			if( worker.joinable() )
+				return true;
+
+			int nl = socket( AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK,
+					NETLINK_ROUTE );
+			if( nl < 0 )
+				return false;
+
+			struct sockaddr_nl addr;
+			memset( &addr, 0, sizeof(addr) );
+			addr.nl_family = AF_NETLINK;
+			addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR;
+			if( ::bind( nl, reinterpret_cast<struct sockaddr*>( &addr ),
+						sizeof(addr) ) < 0 ){
+				int err = errno;
+				close( nl );
+				errno = err;
+				return false;
+			}
+
+			int ev = eventfd( 0, EFD_CLOEXEC );
+			if( ev < 0 ){
+				int err = errno;
+				close( nl );
+				errno = err;
+				return false;
+			}
+
+			sock = nl;
+			stopFd = ev;
+			// Los cambios anteriores a la suscripción no se conocen
+			generation.fetch_add( 1, memory_order_release );
+			worker = thread( &Watcher::run, this );
+			return true;
+		}
+
+		void stop( void )
+		{
+			lock_guard<mutex> lock( mtx );
+
+			if( !worker.joinable() )
+				return;
+
+			uint64_t one = 1;
+			if( write( stopFd, &one, sizeof(one) ) < 0 ){
+				// eventfd sólo falla si el contador se desborda
+			}
+			worker.join();
+			close( sock );
+			close( stopFd );
+		}
+
+	private:
+		mutex mtx;
+		thread worker;
+		int sock = -1;
+		int stopFd = -1;
+
+		void run( void )
+		{
+			struct pollfd fds[2] = { { sock, POLLIN, 0 }, { stopFd, POLLIN, 0 } };
+			char buffer[8192];
+
+			while( true ){
+				if( poll( fds, 2, -1 ) < 0 && errno != EINTR )
+					return;
+				if( fds[1].revents )
+					return;
+
+				// El contenido no importa: cualquier mensaje, o la pérdida
+				// de mensajes, invalida las instantáneas
+				bool changed = false;
+				ssize_t len;
+				while( ( len = recv( sock, buffer, sizeof(buffer), 0 ) ) > 0 ||
+						( len < 0 && ( errno == EINTR || errno == ENOBUFS ) ) )
+					changed = true;
+				if( changed )
+					generation.fetch_add( 1, memory_order_release );
+			}
+		}
+	};
+
+	Watcher watcher;
+
+	/*
+	 * Envía una petición netlink y entrega cada respuesta a handler hasta
+	 * NLMSG_DONE, o hasta la primera respuesta si no es un volcado.
+	 * Regresa falso estableciendo errno si ocurre algún error.
+	 */
+	bool request( int sock, uint16_t type, bool dump, const void *payload,
+			size_t len, const function<void( const struct nlmsghdr* )> &handler )
+	{
+		vector<char> buffer( NLMSG_SPACE( len ) );
+		auto req = reinterpret_cast<struct nlmsghdr*>( buffer.data() );
+
+		req->nlmsg_len = NLMSG_LENGTH( len );
+		req->nlmsg_type = type;
+		req->nlmsg_flags = NLM_F_REQUEST | ( dump ? NLM_F_DUMP : 0 );
+		req->nlmsg_seq = type;
+		memcpy( NLMSG_DATA( req ), payload, len );
+
+		if( send( sock, req, req->nlmsg_len, 0 ) < 0 )
+			return false;
+
+		buffer.resize( 1 << 16 );
+		while( true ){
+			ssize_t size = recv( sock, buffer.data(), buffer.size(), 0 );
+			if( size < 0 ){
+				if( errno == EINTR )
+					continue;
+				return false;
+			}
+
+			int remaining = size;
+			for( auto msg = reinterpret_cast<struct nlmsghdr*>( buffer.data() ) ;
+					NLMSG_OK( msg, remaining ) ; msg = NLMSG_NEXT( msg, remaining ) ){
+				if( msg->nlmsg_seq != type )
+					continue;
+				if( msg->nlmsg_type == NLMSG_DONE )
+					return true;
+				if( msg->nlmsg_type == NLMSG_ERROR ){
+					auto err = static_cast<struct nlmsgerr*>( NLMSG_DATA( msg ) );
+					errno = -err->error;
+					return !err->error;
+				}
+				handler( msg );
+				if( !dump )
+					return true;
+			}
+		}
+	}
+}
+
 
 NetworkInterface::NetworkInterface( string ifname )
 {
@@ -35,10 +207,10 @@ bool NetworkInterface::isPromiscModeEnabled( void ) const
 	if( sfd < 0 )
 		throw system_error( errno, generic_category(), "socket" );
 
-	strcpy( nic.ifr_name, name.c_str() );
+	strcpy( nic.ifr_name, getName().c_str() );
 	if( ioctl( sfd, SIOCGIFFLAGS, &nic ) < 0 ){
 		close( sfd );
-		throw system_error( errno, generic_category(), name );
+		throw system_error( errno, generic_category(), getName() );
 	}
 
 	close( sfd );
@@ -53,7 +225,7 @@ bool NetworkInterface::setPromiscMode( bool value )
 	if( sfd < 0 )
 		return false;
 
-	strcpy( nic.ifr_name, name.c_str() );
+	strcpy( nic.ifr_name, getName().c_str() );
 	if( ioctl( sfd, SIOCGIFFLAGS, &nic ) < 0 ){
 		close( sfd );
 		return false;
@@ -69,48 +241,255 @@ bool NetworkInterface::setPromiscMode( bool value )
 		return false;
 	}
 	close( sfd );
+
+	// El cambio ya se aplicó, así que actualizar la instantánea es sólo un
+	// intento; el aviso de netlink del cambio la invalida de todos modos
+	refresh();
 	return true;
 }
 
-bool NetworkInterface::bind( string ifname )
+IPv4Addr NetworkInterface::getAddress( void ) const
 {
-	struct ifreq nic;
-	int sfd = socket( AF_INET, SOCK_DGRAM, 0 );
+	if( !shared )
+		throw system_error( ENODEV, generic_category(), "NetworkInterface" );
 
-	if( sfd < 0 )
-		return false;
+	auto snap = snapshot();
+	for( auto &addr : snap->addresses )
+		if( !addr.secondary )
+			return addr.address;
+	throw system_error( EADDRNOTAVAIL, generic_category(), snap->name );
+}
+
+IPv4Addr NetworkInterface::getNetmask( void ) const
+{
+	if( !shared )
+		throw system_error( ENODEV, generic_category(), "NetworkInterface" );
 
+	auto snap = snapshot();
+	for( auto &addr : snap->addresses )
+		if( !addr.secondary )
+			return addr.netmask;
+	throw system_error( EADDRNOTAVAIL, generic_category(), snap->name );
+}
+
+HwAddr NetworkInterface::getHwAddress( void ) const
+{
+	if( !shared )
+		throw system_error( ENODEV, generic_category(), "NetworkInterface" );
+	return snapshot()->hwAddress;
+}
+
+bool NetworkInterface::bind( string ifname )
+{
 	if( ifname.size() >= IFNAMSIZ )
 		ifname.resize( IFNAMSIZ - 1 );
 
-	strcpy( nic.ifr_name, ifname.c_str() );
-	if( ioctl( sfd, SIOCGIFINDEX, &nic ) < 0 ){
-		close( sfd );
+	unsigned int idx = if_nametoindex( ifname.c_str() );
+	if( !idx )
 		return false;
-	}
-	close( sfd );
-	name = ifname;
-	index = nic.ifr_ifindex;
-	binded = true;
-	return true;
+	return bind( static_cast<int>( idx ) );
 }
 
 bool NetworkInterface::bind( int index )
 {
-	struct ifreq nic;
-	int sfd = socket( AF_INET, SOCK_DGRAM, 0 );
+	vector<Snapshot> snaps;
 
-	if( sfd < 0 )
+	// La generación se lee antes de obtener los datos para no perder un
+	// cambio que ocurra mientras tanto
+	const uint64_t current = generation.load( memory_order_acquire );
+	if( index <= 0 ){
+		errno = ENODEV;
+		return false;
+	}
+	if( !fetch( index, snaps ) )
 		return false;
 
-	nic.ifr_ifindex = index;
-	if( ioctl( sfd, SIOCGIFNAME, &nic ) < 0 ){
-		close( sfd );
+	snaps[0].generation = current;
+	setSnapshot( make_shared<Snapshot>( move(snaps[0]) ) );
+	return true;
+}
+
+bool NetworkInterface::refresh( void )
+{
+	if( !shared ){
+		errno = ENODEV;
 		return false;
 	}
-	close( sfd );
-	name = nic.ifr_name;
-	this->index = index;
-	binded = true;
+
+	vector<Snapshot> snaps;
+	const uint64_t current = generation.load( memory_order_acquire );
+	if( !fetch( index, snaps ) )
+		return false;
+
+	snaps[0].generation = current;
+	atomic_store( &shared->snap,
+			shared_ptr<const Snapshot>( make_shared<Snapshot>( move(snaps[0]) ) ) );
 	return true;
 }
+
+bool NetworkInterface::enableAutoRefresh( void )
+{
+	return watcher.start();
+}
+
+void NetworkInterface::disableAutoRefresh( void )
+{
+	watcher.stop();
+}
+
+vector<NetworkInterface> NetworkInterface::enumerate( void )
+{
+	vector<Snapshot> snaps;
+	const uint64_t current = generation.load( memory_order_acquire );
+
+	if( !fetch( 0, snaps ) )
+		throw system_error( errno, generic_category(), "NetworkInterface::enumerate" );
+
+	sort( snaps.begin(), snaps.end(), []( const Snapshot &a, const Snapshot &b ){
+			return a.index < b.index;
+		} );
+
+	vector<NetworkInterface> result( snaps.size() );
+	for( size_t i = 0 ; i < snaps.size() ; i++ ){
+		snaps[i].generation = current;
+		result[i].setSnapshot( make_shared<Snapshot>( move(snaps[i]) ) );
+	}
+	return result;
+}
+
+shared_ptr<const NetworkInterface::Snapshot> NetworkInterface::snapshot( void ) const
+{
+	auto snap = atomic_load( &shared->snap );
+	const uint64_t current = generation.load( memory_order_acquire );
+
+	if( snap->generation != current ){
+		vector<Snapshot> snaps;
+		shared_ptr<Snapshot> fresh;
+
+		// Si la interfaz ya no existe se conservan los últimos datos
+		if( fetch( index, snaps ) )
+			fresh = make_shared<Snapshot>( move(snaps[0]) );
+		else
+			fresh = make_shared<Snapshot>( *snap );
+		fresh->generation = current;
+		atomic_store( &shared->snap, shared_ptr<const Snapshot>( fresh ) );
+		snap = fresh;
+	}
+	return snap;
+}
+
+void NetworkInterface::setSnapshot( shared_ptr<const Snapshot> snap )
+{
+	index = snap->index;
+	shared = make_shared<Shared>();
+	shared->snap = move(snap);
+}
+
+bool NetworkInterface::fetch( int index, vector<Snapshot> &snaps )
+{
+	int sock = socket( AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE );
+	if( sock < 0 )
+		return false;
+
+	// Con la verificación estricta el kernel filtra las direcciones por
+	// interfaz; sin ella se filtran aquí
+	int one = 1;
+	setsockopt( sock, SOL_NETLINK, NETLINK_GET_STRICT_CHK, &one, sizeof(one) );
+
+	unordered_map<int, size_t> position;
+	struct ifinfomsg ifi;
+	memset( &ifi, 0, sizeof(ifi) );
+	ifi.ifi_family = AF_UNSPEC;
+	ifi.ifi_index = index;
+
+	bool ok = request( sock, RTM_GETLINK, !index, &ifi, sizeof(ifi),
+			[&snaps, &position]( const struct nlmsghdr *msg ){
+				if( msg->nlmsg_type != RTM_NEWLINK ||
+						msg->nlmsg_len < NLMSG_LENGTH( sizeof(struct ifinfomsg) ) )
+					return;
+
+				auto info = static_cast<const struct ifinfomsg*>( NLMSG_DATA( msg ) );
+				Snapshot snap;
+				snap.index = info->ifi_index;
+				snap.flags = info->ifi_flags;
+
+				int len = IFLA_PAYLOAD( msg );
+				for( auto rta = IFLA_RTA( info ) ; RTA_OK( rta, len ) ;
+						rta = RTA_NEXT( rta, len ) ){
+					const void *data = RTA_DATA( rta );
+					const size_t size = RTA_PAYLOAD( rta );
+
+					switch( rta->rta_type ){
+						case IFLA_IFNAME:
+							snap.name.assign( static_cast<const char*>( data ),
+									strnlen( static_cast<const char*>( data ), size ) );
+							break;
+						case IFLA_ADDRESS:
+							// Como SIOCGIFHWADDR, se toman los primeros 6 bytes
+							if( size >= HwAddr::HwAddrLen )
+								snap.hwAddress.setData( static_cast<const uint8_t*>( data ) );
+							break;
+						case IFLA_MTU:
+							if( size == sizeof(uint32_t) )
+								memcpy( &snap.mtu, data, sizeof(uint32_t) );
+							break;
+						case IFLA_OPERSTATE:
+							if( size == sizeof(uint8_t) )
+								snap.operState = static_cast<OperState>(
+										*static_cast<const uint8_t*>( data ) );
+							break;
+					}
+				}
+				position[snap.index] = snaps.size();
+				snaps.push_back( move(snap) );
+			} );
+
+	struct ifaddrmsg ifa;
+	memset( &ifa, 0, sizeof(ifa) );
+	ifa.ifa_family = AF_INET;
+	ifa.ifa_index = index;
+
+	ok = ok && request( sock, RTM_GETADDR, true, &ifa, sizeof(ifa),
+			[&snaps, &position]( const struct nlmsghdr *msg ){
+				if( msg->nlmsg_type != RTM_NEWADDR ||
+						msg->nlmsg_len < NLMSG_LENGTH( sizeof(struct ifaddrmsg) ) )
+					return;
+
+				auto info = static_cast<const struct ifaddrmsg*>( NLMSG_DATA( msg ) );
+				auto it = position.find( info->ifa_index );
+				if( info->ifa_family != AF_INET || it == position.end() )
+					return;
+
+				Address addr;
+				uint32_t local = 0, peer = 0, broadcast = 0;
+				addr.secondary = info->ifa_flags & IFA_F_SECONDARY;
+				addr.netmask = IPv4Addr( info->ifa_prefixlen ? htonl(
+							0xffffffffU << ( 32 - info->ifa_prefixlen ) ) : 0 );
+
+				int len = IFA_PAYLOAD( msg );
+				for( auto rta = IFA_RTA( info ) ; RTA_OK( rta, len ) ;
+						rta = RTA_NEXT( rta, len ) ){
+					if( RTA_PAYLOAD( rta ) != sizeof(uint32_t) )
+						continue;
+					if( rta->rta_type == IFA_LOCAL )
+						memcpy( &local, RTA_DATA( rta ), sizeof(uint32_t) );
+					else if( rta->rta_type == IFA_ADDRESS )
+						memcpy( &peer, RTA_DATA( rta ), sizeof(uint32_t) );
+					else if( rta->rta_type == IFA_BROADCAST )
+						memcpy( &broadcast, RTA_DATA( rta ), sizeof(uint32_t) );
+				}
+				// En enlaces punto a punto IFA_ADDRESS es la dirección remota
+				addr.address = IPv4Addr( local ? local : peer );
+				addr.broadcast = IPv4Addr( broadcast );
+				snaps[it->second].addresses.push_back( addr );
+			} );
+
+	int err = errno;
+	close( sock );
+	if( ok && snaps.empty() ){
+		ok = false;
+		err = ENODEV;
+	}
+	errno = err;
+	return ok;
+}
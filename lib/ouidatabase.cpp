@@ -0,0 +1,411 @@
+#include <reroman/ouidatabase.hpp>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+using namespace reroman;
+
+struct OuiDatabase::Header
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t slots;
+	uint32_t used;			// Ranuras ocupadas, incluidos los OUI padre
+	uint32_t namesSize;
+	uint32_t assignments;	// Asignaciones de los registros
+	uint32_t reserved;
+};
+
+struct OuiDatabase::Slot
+{
+	uint64_t key;		// Prefijo << 8 | longitud en bits; 0 si está libre
+	uint32_t name;		// Desplazamiento en la tabla de nombres; 0 si no hay
+	uint32_t flags;
+};
+
+namespace
+{
+	const char Magic[8] = { 'R', 'E', 'R', 'O', 'O', 'U', 'I', '\0' };
+	constexpr uint32_t Version = 2;
+	constexpr uint32_t HasMAM = 1;
+	constexpr uint32_t HasMAS = 2;
+
+	inline uint64_t makeKey( uint64_t prefix, unsigned int bits )
+	{
+		return prefix << 8 | bits;
+	}
+
+	inline uint32_t hashKey( uint64_t key )
+	{
+		return ( key * 0x9e3779b97f4a7c15ULL ) >> 32;
+	}
+
+	inline int hexValue( char c )
+	{
+		if( c >= '0' && c <= '9' )
+			return c - '0';
+		if( c >= 'A' && c <= 'F' )
+			return c - 'A' + 10;
+		if( c >= 'a' && c <= 'f' )
+			return c - 'a' + 10;
+		return -1;
+	}
+
+	string readFile( const string &path )
+	{
+		int fd = ::open( path.c_str(), O_RDONLY | O_CLOEXEC );
+		if( fd < 0 )
+			throw system_error( errno, generic_category(), path );
+
+		string text;
+		char buffer[65536];
+		ssize_t n;
+
+		while( ( n = read( fd, buffer, sizeof(buffer) ) ) != 0 ){
+			if( n < 0 ){
+				if( errno == EINTR )
+					continue;
+				int err = errno;
+				::close( fd );
+				throw system_error( err, generic_category(), path );
+			}
+			text.append( buffer, n );
+		}
+		::close( fd );
+		return text;
+	}
+
+	void writeAll( int fd, const void *data, size_t len, const string &path )
+	{
+		const char *p = static_cast<const char*>( data );
+
+		while( len ){
+			ssize_t n = write( fd, p, len );
+			if( n < 0 ){
+				if( errno == EINTR )
+					continue;
+				throw system_error( errno, generic_category(), path );
+			}
+			p += n;
+			len -= n;
+		}
+	}
+
+	string trim( const string &s )
+	{
+		size_t begin = s.find_first_not_of( " \t" );
+		if( begin == string::npos )
+			return string();
+		return s.substr( begin, s.find_last_not_of( " \t" ) - begin + 1 );
+	}
+
+	// Procesa un registro CSV del IEEE y agrega sus asignaciones
+	void parseRegistry( const string &text, const string &path,
+			unordered_map<uint64_t, string> &assignments )
+	{
+		vector<string> fields( 1 );
+		size_t line = 1, recordLine = 1;
+		bool quoted = false;
+
+		for( size_t i = 0 ; i <= text.size() ; i++ ){
+			const char c = i < text.size() ? text[i] : '\n';
+
+			if( quoted ){
+				if( c == '"' && i + 1 < text.size() && text[i + 1] == '"' ){
+					fields.back() += '"';
+					i++;
+				}
+				else if( c == '"' )
+					quoted = false;
+				else{
+					if( c == '\n' )
+						line++;
+					fields.back() += c;
+				}
+				continue;
+			}
+			if( c == '"' ){
+				quoted = true;
+				continue;
+			}
+			if( c == ',' ){
+				fields.emplace_back();
+				continue;
+			}
+			if( c == '\r' )
+				continue;
+			if( c != '\n' ){
+				fields.back() += c;
+				continue;
+			}
+
+			// Fin del registro
+			const string registry = trim( fields[0] );
+			unsigned int digits = 0;
+
+			if( registry == "MA-L" )
+				digits = 6;
+			else if( registry == "MA-M" )
+				digits = 7;
+			else if( registry == "MA-S" || registry == "IAB" )
+				digits = 9;
+
+			if( digits ){
+				if( fields.size() < 3 )
+					throw invalid_argument( path + ": line " +
+							to_string( recordLine ) + ": missing fields" );
+
+				const string assignment = trim( fields[1] );
+				uint64_t prefix = 0;
+
+				if( assignment.size() != digits )
+					throw invalid_argument( path + ": line " +
+							to_string( recordLine ) + ": invalid assignment" );
+				for( char h : assignment ){
+					const int value = hexValue( h );
+					if( value < 0 )
+						throw invalid_argument( path + ": line " +
+								to_string( recordLine ) + ": invalid assignment" );
+					prefix = prefix << 4 | value;
+				}
+				assignments[makeKey( prefix, digits * 4 )] = trim( fields[2] );
+			}
+
+			fields.assign( 1, string() );
+			recordLine = ++line;
+		}
+	}
+}
+
+OuiDatabase::OuiDatabase( const string &path )
+{
+	open( path );
+}
+
+OuiDatabase::OuiDatabase( OuiDatabase &&db ) noexcept
+{
+	*this = move( db );
+}
+
+OuiDatabase& OuiDatabase::operator=( OuiDatabase &&db ) noexcept
+{
+	if( this != &db ){
+		close();
+		swap( map, db.map );
+		swap( mapSize, db.mapSize );
+		swap( slots, db.slots );
+		swap( names, db.names );
+		swap( mask, db.mask );
+		swap( entries, db.entries );
+	}
+	return *this;
+}
+
+OuiDatabase::~OuiDatabase( void )
+{
+	close();
+}
+
+const char* OuiDatabase::vendorOf( const HwAddr &addr ) const noexcept
+{
+	if( !slots )
+		return nullptr;
+
+	const uint64_t mac = addr.toUint64();
+
+	const Slot *oui = find( makeKey( mac >> 24, 24 ) );
+	if( !oui )
+		return nullptr;
+
+	if( oui->flags & HasMAS ){
+		const Slot *s = find( makeKey( mac >> 12, 36 ) );
+		if( s )
+			return names + s->name;
+	}
+	if( oui->flags & HasMAM ){
+		const Slot *s = find( makeKey( mac >> 20, 28 ) );
+		if( s )
+			return names + s->name;
+	}
+	return oui->name ? names + oui->name : nullptr;
+}
+
+void OuiDatabase::open( const string &path )
+{
+	close();
+
+	int fd = ::open( path.c_str(), O_RDONLY | O_CLOEXEC );
+	if( fd < 0 )
+		throw system_error( errno, generic_category(), path );
+
+	struct stat info;
+	if( fstat( fd, &info ) < 0 ){
+		int err = errno;
+		::close( fd );
+		throw system_error( err, generic_category(), path );
+	}
+	if( static_cast<size_t>( info.st_size ) < sizeof(Header) ){
+		::close( fd );
+		throw invalid_argument( path + ": not an OUI database" );
+	}
+
+	void *data = mmap( nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+	int err = errno;
+	::close( fd );
+	if( data == MAP_FAILED )
+		throw system_error( err, generic_category(), path );
+
+	// Valida la estructura para que las búsquedas no salgan del archivo
+	const Header *header = static_cast<const Header*>( data );
+	const uint64_t slotCount = header->slots;
+	const uint64_t expected = sizeof(Header) + slotCount * sizeof(Slot) +
+		header->namesSize;
+	bool valid = !memcmp( header->magic, Magic, sizeof(Magic) ) &&
+		header->version == Version && slotCount &&
+		!( slotCount & ( slotCount - 1 ) ) && slotCount <= 1ULL << 31 &&
+		expected == static_cast<uint64_t>( info.st_size ) &&
+		header->namesSize && header->used < slotCount &&
+		header->assignments <= header->used;
+
+	if( valid ){
+		const Slot *table = reinterpret_cast<const Slot*>( header + 1 );
+		const char *strings = reinterpret_cast<const char*>( table + slotCount );
+
+		uint64_t used = 0;
+
+		// find() termina al llegar a una ranura vacía, por lo que la tabla
+		// debe tener al menos una
+		valid = strings[0] == '\0' && strings[header->namesSize - 1] == '\0';
+		for( uint64_t i = 0 ; valid && i < slotCount ; i++ ){
+			valid = table[i].name < header->namesSize;
+			if( table[i].key )
+				used++;
+		}
+		if( valid && used == header->used ){
+			map = data;
+			mapSize = info.st_size;
+			slots = table;
+			names = strings;
+			mask = slotCount - 1;
+			entries = header->assignments;
+			return;
+		}
+	}
+
+	munmap( data, info.st_size );
+	throw invalid_argument( path + ": not an OUI database" );
+}
+
+void OuiDatabase::close( void ) noexcept
+{
+	if( map )
+		munmap( map, mapSize );
+	map = nullptr;
+	mapSize = 0;
+	slots = nullptr;
+	names = nullptr;
+	mask = 0;
+	entries = 0;
+}
+
+const OuiDatabase::Slot* OuiDatabase::find( uint64_t key ) const noexcept
+{
+	for( uint32_t i = hashKey( key ) & mask ; slots[i].key ; i = ( i + 1 ) & mask ){
+		if( slots[i].key == key )
+			return slots + i;
+	}
+	return nullptr;
+}
+
+size_t OuiDatabase::compile( const vector<string> &registries, const string &output )
+{
+	unordered_map<uint64_t, string> assignments;
+
+	for( const auto &path : registries )
+		parseRegistry( readFile( path ), path, assignments );
+
+	// Tabla al 50% como máximo, incluidos los OUI padre que se agreguen
+	uint32_t slotCount = 16;
+	while( slotCount < assignments.size() * 4 )
+		slotCount <<= 1;
+
+	vector<Slot> table( slotCount, Slot{ 0, 0, 0 } );
+	string strings( 1, '\0' );
+	unordered_map<string, uint32_t> offsets;
+	const uint32_t tableMask = slotCount - 1;
+	uint32_t count = 0;
+
+	auto slotOf = [&]( uint64_t key ) -> Slot&{
+		uint32_t i = hashKey( key ) & tableMask;
+		while( table[i].key && table[i].key != key )
+			i = ( i + 1 ) & tableMask;
+		if( !table[i].key ){
+			table[i].key = key;
+			count++;
+		}
+		return table[i];
+	};
+
+	for( const auto &a : assignments ){
+		const unsigned int bits = a.first & 0xff;
+		const uint64_t prefix = a.first >> 8;
+		uint32_t name = 0;
+
+		if( !a.second.empty() ){
+			auto it = offsets.find( a.second );
+			if( it == offsets.end() ){
+				it = offsets.emplace( a.second, strings.size() ).first;
+				strings.append( a.second.c_str(), a.second.size() + 1 );
+			}
+			name = it->second;
+		}
+		slotOf( a.first ).name = name;
+		if( bits > 24 )
+			slotOf( makeKey( prefix >> ( bits - 24 ), 24 ) ).flags |=
+				bits == 28 ? HasMAM : HasMAS;
+	}
+
+	Header header;
+	memcpy( header.magic, Magic, sizeof(Magic) );
+	header.version = Version;
+	header.slots = slotCount;
+	header.used = count;
+	header.namesSize = strings.size();
+	header.assignments = assignments.size();
+	header.reserved = 0;
+
+	string temp = output + ".XXXXXX";
+	int fd = mkostemp( &temp[0], O_CLOEXEC );
+	if( fd < 0 )
+		throw system_error( errno, generic_category(), output );
+
+	try{
+		writeAll( fd, &header, sizeof(header), output );
+		writeAll( fd, table.data(), table.size() * sizeof(Slot), output );
+		writeAll( fd, strings.data(), strings.size(), output );
+		if( fchmod( fd, 0644 ) < 0 || fsync( fd ) < 0 )
+			throw system_error( errno, generic_category(), output );
+		if( ::close( fd ) < 0 ){
+			fd = -1;
+			throw system_error( errno, generic_category(), output );
+		}
+		fd = -1;
+		if( rename( temp.c_str(), output.c_str() ) < 0 )
+			throw system_error( errno, generic_category(), output );
+	}catch( ... ){
+		if( fd >= 0 )
+			::close( fd );
+		unlink( temp.c_str() );
+		throw;
+	}
+	return assignments.size();
+}
@@ -0,0 +1,182 @@
+#include <reroman/arp/scanresult.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+using namespace reroman;
+using namespace reroman::arp;
+
+namespace
+{
+	constexpr size_t MacLen = HwAddr::HwAddrLen;
+}
+
+ScanResult::ScanResult( const IPv4Range &range ) :
+	first( range.getFirst().toHostInt() ),
+	size( range.getSize() ),
+	bits( ( size + 63 ) / 64 ),
+	ranks( bits.size() )
+{
+	if( !size )
+		first = 0;
+}
+
+bool ScanResult::getHwAddr( const IPv4Addr &addr, HwAddr &hw ) const
+{
+	if( !isAlive( addr ) )
+		return false;
+	hw.setData( macs.data() + rank( addr.toHostInt() - first ) * MacLen );
+	return true;
+}
+
+void ScanResult::forEach( const HostHandler &handler ) const
+{
+	const uint8_t *mac = macs.data();
+
+	for( size_t w = 0 ; w < bits.size() ; w++ ){
+		for( uint64_t word = bits[w] ; word ; word &= word - 1 ){
+			const uint32_t offset = w * 64 + __builtin_ctzll( word );
+
+			handler( IPv4Addr( htonl( first + offset ) ), HwAddr( mac ) );
+			mac += MacLen;
+		}
+	}
+}
+
+bool ScanResult::add( const IPv4Addr &addr, const HwAddr &hw )
+{
+	const uint32_t offset = addr.toHostInt() - first;
+
+	if( offset >= size )
+		return false;
+
+	Entry entry;
+	entry.offset = offset;
+	hw.copyTo( entry.hw.data() );
+	pending.push_back( entry );
+	return true;
+}
+
+size_t ScanResult::merge( const ScanResult &result )
+{
+	size_t count = 0;
+
+	result.forEach( [this, &count]( const IPv4Addr &ip, const HwAddr &hw ){
+			if( add( ip, hw ) )
+				count++;
+		} );
+	return count;
+}
+
+void ScanResult::commit( void )
+{
+	if( pending.empty() )
+		return;
+
+	stable_sort( pending.begin(), pending.end(),
+			[]( const Entry &a, const Entry &b ){
+				return a.offset < b.offset;
+			} );
+
+	vector<uint8_t> merged;
+	size_t copied = 0;	// Hosts anteriores ya copiados
+
+	merged.reserve( macs.size() + pending.size() * MacLen );
+	for( size_t i = 0 ; i < pending.size() ; i++ ){
+		const Entry &entry = pending[i];
+
+		// Entre repetidos gana el último agregado
+		if( i + 1 < pending.size() && pending[i + 1].offset == entry.offset )
+			continue;
+
+		const size_t pos = rank( entry.offset );
+		merged.insert( merged.end(), macs.begin() + copied * MacLen,
+				macs.begin() + pos * MacLen );
+		copied = pos + ( ( bits[entry.offset >> 6] >> ( entry.offset & 63 ) ) & 1 );
+		merged.insert( merged.end(), entry.hw.begin(), entry.hw.end() );
+	}
+	merged.insert( merged.end(), macs.begin() + copied * MacLen, macs.end() );
+
+	for( const auto &entry : pending )
+		bits[entry.offset >> 6] |= 1ULL << ( entry.offset & 63 );
+	macs.swap( merged );
+	pending.clear();
+	updateRanks();
+}
+
+void ScanResult::clear( void ) noexcept
+{
+	fill( bits.begin(), bits.end(), 0 );
+	fill( ranks.begin(), ranks.end(), 0 );
+	macs.clear();
+	pending.clear();
+}
+
+ScanDiff ScanResult::diff( const ScanResult &before, const ScanResult &after )
+{
+	if( before.first != after.first || before.size != after.size )
+		throw invalid_argument( "Scan results cover different ranges" );
+
+	const IPv4Range range = before.getRange();
+	ScanDiff result{ ScanResult( range ), ScanResult( range ), ScanResult( range ) };
+	const uint8_t *macA = before.macs.data();
+	const uint8_t *macB = after.macs.data();
+
+	for( size_t w = 0 ; w < before.bits.size() ; w++ ){
+		const uint64_t a = before.bits[w];
+		const uint64_t b = after.bits[w];
+
+		if( a == b ){
+			const size_t len = __builtin_popcountll( a ) * MacLen;
+
+			if( !memcmp( macA, macB, len ) ){
+				macA += len;
+				macB += len;
+				continue;
+			}
+		}
+
+		for( uint64_t word = a | b ; word ; word &= word - 1 ){
+			const int bit = __builtin_ctzll( word );
+			const uint64_t mask = 1ULL << bit;
+			const uint32_t offset = w * 64 + bit;
+
+			if( a & b & mask ){
+				if( memcmp( macA, macB, MacLen ) )
+					result.changed.append( offset, macB );
+				macA += MacLen;
+				macB += MacLen;
+			}
+			else if( a & mask ){
+				result.removed.append( offset, macA );
+				macA += MacLen;
+			}
+			else{
+				result.added.append( offset, macB );
+				macB += MacLen;
+			}
+		}
+	}
+
+	result.added.updateRanks();
+	result.removed.updateRanks();
+	result.changed.updateRanks();
+	return result;
+}
+
+void ScanResult::append( uint32_t offset, const uint8_t *hw )
+{
+	bits[offset >> 6] |= 1ULL << ( offset & 63 );
+	macs.insert( macs.end(), hw, hw + MacLen );
+}
+
+void ScanResult::updateRanks( void )
+{
+	uint32_t count = 0;
+
+	for( size_t w = 0 ; w < bits.size() ; w++ ){
+		ranks[w] = count;
+		count += __builtin_popcountll( bits[w] );
+	}
+}
@@ -0,0 +1,134 @@
+#include <reroman/targetlist.hpp>
+#include <reroman/ipv4network.hpp>
+#include <stdexcept>
+#include <system_error>
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+using namespace reroman;
+
+namespace
+{
+	inline bool isSeparator( char c )
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == ',' || c == ';';
+	}
+
+	inline bool isTokenEnd( const char *p, const char *end )
+	{
+		return p == end || isSeparator( *p ) || *p == '\n' || *p == '#';
+	}
+
+	[[noreturn]] void fail( size_t line, const char *what )
+	{
+		throw invalid_argument( "line " + to_string( line ) + ": " + what );
+	}
+}
+
+TargetList::TargetList( const string &path )
+{
+	load( path );
+}
+
+size_t TargetList::load( const string &path )
+{
+	int fd = open( path.c_str(), O_RDONLY | O_CLOEXEC );
+	if( fd < 0 )
+		throw system_error( errno, generic_category(), path );
+
+	struct stat info;
+	if( fstat( fd, &info ) < 0 ){
+		int err = errno;
+		close( fd );
+		throw system_error( err, generic_category(), path );
+	}
+	if( !info.st_size ){
+		close( fd );
+		return 0;
+	}
+
+	void *text = mmap( nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	int err = errno;
+	close( fd );
+	if( text == MAP_FAILED )
+		throw system_error( err, generic_category(), path );
+	madvise( text, info.st_size, MADV_SEQUENTIAL );
+
+	try{
+		size_t added = parse( static_cast<const char*>( text ), info.st_size );
+		munmap( text, info.st_size );
+		return added;
+	}catch( const invalid_argument &e ){
+		munmap( text, info.st_size );
+		throw invalid_argument( path + ": " + e.what() );
+	}
+}
+
+size_t TargetList::parse( const char *text, size_t len )
+{
+	const char *end = text + len;
+	const char *p = text;
+	const size_t before = targets.size();
+	size_t line = 1;
+	IPv4Addr addr;
+
+	while( p < end ){
+		if( *p == '\n' ){
+			line++;
+			p++;
+			continue;
+		}
+		if( isSeparator( *p ) ){
+			p++;
+			continue;
+		}
+		if( *p == '#' ){
+			while( p < end && *p != '\n' )
+				p++;
+			continue;
+		}
+
+		CharsResult result = addr.fromChars( p, end - p );
+		if( result.ec != errc() )
+			fail( line, "invalid IPv4 address" );
+		p = result.ptr;
+
+		if( p == end || *p != '/' ){
+			if( !isTokenEnd( p, end ) )
+				fail( line, "invalid IPv4 address" );
+			targets.push_back( addr.toNetworkInt() );
+			continue;
+		}
+
+		unsigned int prefix;
+		p++;
+		result = IPv4Network::prefixFromChars( p, end - p, prefix );
+		p = result.ptr;
+		if( result.ec != errc() || !isTokenEnd( p, end ) )
+			fail( line, "invalid prefix length" );
+		if( prefix < MinPrefix )
+			fail( line, "prefix length too short" );
+
+		const uint32_t size = prefix ? 1U << ( 32 - prefix ) : 0;
+		const uint32_t mask = ~( size - 1 );
+		uint32_t first = addr.toHostInt() & mask;
+		uint32_t count = size;
+
+		// Sin direcciones de red y difusión excepto en /31 y /32
+		if( prefix <= 30 ){
+			first++;
+			count -= 2;
+		}
+		const size_t offset = targets.size();
+		targets.resize( offset + count );
+		for( uint32_t i = 0 ; i < count ; i++ )
+			targets[offset + i] = htonl( first + i );
+	}
+	return targets.size() - before;
+}